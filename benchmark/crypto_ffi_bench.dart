@@ -0,0 +1,462 @@
+// FFI round-trip benchmark for lib/services/crypto_ffi.dart.
+//
+// Every case is measured twice: once through the public CryptoFFI method
+// (Dart -> native copies, wipes, string conversion, result decoding) and
+// once as the bare native call on buffers prepared up front. The difference
+// is the cost of the binding layer.
+//
+// Build the host library first, then point the loader at it:
+//
+//   cmake -S src -B build/native && cmake --build build/native
+//   LD_LIBRARY_PATH=build/native dart run benchmark/crypto_ffi_bench.dart \
+//       [--quick] [--filter TEXT] [--min-time SECONDS] [--output FILE]
+//
+// A table goes to stderr; --output writes the results as JSON (same layout
+// as native_crypto_bench, plus the FFI / native split per case).
+
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+import 'package:notehider/services/crypto_ffi.dart';
+
+// --- Raw native entry points (signatures as in src/*.h) ----------------------
+
+typedef _BytesToB64C = Pointer<Utf8> Function(
+    Pointer<Uint8> data, IntPtr len, Pointer<Uint8> key, IntPtr keyLen);
+typedef _BytesToB64Dart = Pointer<Utf8> Function(
+    Pointer<Uint8> data, int len, Pointer<Uint8> key, int keyLen);
+
+typedef _B64ToB64C = Pointer<Utf8> Function(
+    Pointer<Utf8> enc, Pointer<Uint8> key, IntPtr keyLen);
+typedef _B64ToB64Dart = Pointer<Utf8> Function(
+    Pointer<Utf8> enc, Pointer<Uint8> key, int keyLen);
+
+typedef _FreeStringC = Void Function(Pointer<Utf8> str);
+typedef _FreeStringDart = void Function(Pointer<Utf8> str);
+
+typedef _CodecC = Int64 Function(
+    Pointer<Uint8> input, IntPtr inLen, Pointer<Uint8> out, IntPtr outCap);
+typedef _CodecDart = int Function(
+    Pointer<Uint8> input, int inLen, Pointer<Uint8> out, int outCap);
+
+typedef _HashBytesC = Int32 Function(Int32 alg, Pointer<Uint8> data,
+    IntPtr len, Pointer<Uint8> out, IntPtr outLen);
+typedef _HashBytesDart = int Function(
+    int alg, Pointer<Uint8> data, int len, Pointer<Uint8> out, int outLen);
+
+typedef _BufferHashedC = Int32 Function(
+    Pointer<Uint8> data,
+    IntPtr len,
+    Pointer<Uint8> key,
+    IntPtr keyLen,
+    Pointer<Uint8> ad,
+    IntPtr adLen,
+    Int32 hashAlg,
+    Pointer<Uint8> digest,
+    IntPtr digestLen,
+    Pointer<Uint8> out,
+    IntPtr outCap,
+    Pointer<IntPtr> outLen);
+typedef _BufferHashedDart = int Function(
+    Pointer<Uint8> data,
+    int len,
+    Pointer<Uint8> key,
+    int keyLen,
+    Pointer<Uint8> ad,
+    int adLen,
+    int hashAlg,
+    Pointer<Uint8> digest,
+    int digestLen,
+    Pointer<Uint8> out,
+    int outCap,
+    Pointer<IntPtr> outLen);
+
+typedef _ContainerSizeC = IntPtr Function(IntPtr plainLen);
+typedef _ContainerSizeDart = int Function(int plainLen);
+
+typedef _MemzeroC = Int32 Function(Pointer<Void> ptr, IntPtr len);
+typedef _MemzeroDart = int Function(Pointer<Void> ptr, int len);
+
+typedef _SessionKeyC = Pointer<Utf8> Function(Pointer<Uint8> master,
+    IntPtr masterLen, Pointer<Uint8> eph, IntPtr ephLen, Pointer<Uint8> salt,
+    IntPtr saltLen);
+typedef _SessionKeyDart = Pointer<Utf8> Function(Pointer<Uint8> master,
+    int masterLen, Pointer<Uint8> eph, int ephLen, Pointer<Uint8> salt,
+    int saltLen);
+
+typedef _RandomB64C = Pointer<Utf8> Function(IntPtr len);
+typedef _RandomB64Dart = Pointer<Utf8> Function(int len);
+
+typedef _HashPasswordC = Pointer<Utf8> Function(Pointer<Utf8> password);
+typedef _HashPasswordDart = Pointer<Utf8> Function(Pointer<Utf8> password);
+
+typedef _VerifyPasswordC = Bool Function(
+    Pointer<Utf8> hash, Pointer<Utf8> password);
+typedef _VerifyPasswordDart = bool Function(
+    Pointer<Utf8> hash, Pointer<Utf8> password);
+
+typedef _OtpKeyNewC = Pointer<Void> Function(Int32 alg, Pointer<Utf8> secret);
+typedef _OtpKeyNewDart = Pointer<Void> Function(int alg, Pointer<Utf8> secret);
+typedef _OtpKeyFreeC = Void Function(Pointer<Void> key);
+typedef _OtpKeyFreeDart = void Function(Pointer<Void> key);
+typedef _TotpGenerateC = Int64 Function(
+    Pointer<Void> key, Uint64 unixTime, Uint32 step, Int32 digits);
+typedef _TotpGenerateDart = int Function(
+    Pointer<Void> key, int unixTime, int step, int digits);
+
+class _Native {
+  _Native(DynamicLibrary lib)
+      : encryptBytes = lib.lookupFunction<_BytesToB64C, _BytesToB64Dart>(
+            'encrypt_bytes'),
+        decryptBytes =
+            lib.lookupFunction<_B64ToB64C, _B64ToB64Dart>('decrypt_bytes'),
+        freeString =
+            lib.lookupFunction<_FreeStringC, _FreeStringDart>('free_string'),
+        base64Encode =
+            lib.lookupFunction<_CodecC, _CodecDart>('base64_encode'),
+        base64Decode =
+            lib.lookupFunction<_CodecC, _CodecDart>('base64_decode'),
+        hashBytes =
+            lib.lookupFunction<_HashBytesC, _HashBytesDart>('hash_bytes'),
+        encryptBufferHashed =
+            lib.lookupFunction<_BufferHashedC, _BufferHashedDart>(
+                'encrypt_buffer_hashed'),
+        containerEncryptedSize =
+            lib.lookupFunction<_ContainerSizeC, _ContainerSizeDart>(
+                'container_encrypted_size'),
+        secureMemzero =
+            lib.lookupFunction<_MemzeroC, _MemzeroDart>('secure_memzero'),
+        deriveSessionKey = lib.lookupFunction<_SessionKeyC, _SessionKeyDart>(
+            'derive_session_key_b64'),
+        randomBytesB64 = lib
+            .lookupFunction<_RandomB64C, _RandomB64Dart>('random_bytes_b64'),
+        hashPassword = lib.lookupFunction<_HashPasswordC, _HashPasswordDart>(
+            'hash_password'),
+        verifyPassword =
+            lib.lookupFunction<_VerifyPasswordC, _VerifyPasswordDart>(
+                'verify_password'),
+        otpKeyNewBase32 = lib
+            .lookupFunction<_OtpKeyNewC, _OtpKeyNewDart>('otp_key_new_base32'),
+        otpKeyFree =
+            lib.lookupFunction<_OtpKeyFreeC, _OtpKeyFreeDart>('otp_key_free'),
+        totpGenerate = lib.lookupFunction<_TotpGenerateC, _TotpGenerateDart>(
+            'totp_generate');
+
+  final _BytesToB64Dart encryptBytes;
+  final _B64ToB64Dart decryptBytes;
+  final _FreeStringDart freeString;
+  final _CodecDart base64Encode;
+  final _CodecDart base64Decode;
+  final _HashBytesDart hashBytes;
+  final _BufferHashedDart encryptBufferHashed;
+  final _ContainerSizeDart containerEncryptedSize;
+  final _MemzeroDart secureMemzero;
+  final _SessionKeyDart deriveSessionKey;
+  final _RandomB64Dart randomBytesB64;
+  final _HashPasswordDart hashPassword;
+  final _VerifyPasswordDart verifyPassword;
+  final _OtpKeyNewDart otpKeyNewBase32;
+  final _OtpKeyFreeDart otpKeyFree;
+  final _TotpGenerateDart totpGenerate;
+}
+
+// --- Measurement -------------------------------------------------------------
+
+class _Options {
+  bool quick = false;
+  String? filter;
+  Duration? minTime;
+  String? output;
+
+  Duration get budget =>
+      minTime ?? Duration(milliseconds: quick ? 100 : 500);
+}
+
+class _Stats {
+  _Stats(List<int> samplesNs)
+      : iterations = samplesNs.length,
+        min = samplesNs.first,
+        p50 = _percentile(samplesNs, 50),
+        p90 = _percentile(samplesNs, 90),
+        p99 = _percentile(samplesNs, 99),
+        mean = samplesNs.reduce((a, b) => a + b) / samplesNs.length;
+
+  final int iterations;
+  final int min;
+  final int p50;
+  final int p90;
+  final int p99;
+  final double mean;
+
+  // Nearest-rank percentile of sorted samples.
+  static int _percentile(List<int> sorted, int pct) {
+    final rank = (sorted.length * pct + 99) ~/ 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+  }
+
+  Map<String, dynamic> toJson() => {
+        'iterations': iterations,
+        'min': min,
+        'p50': p50,
+        'p90': p90,
+        'p99': p99,
+        'mean': mean.round(),
+      };
+}
+
+class _Result {
+  _Result(this.id, this.size, this.ffi, this.native);
+
+  final String id;
+  final int size;
+  final _Stats ffi;
+  final _Stats native;
+
+  int get overheadNs => ffi.p50 - native.p50;
+  double get ratio => native.p50 == 0 ? 0 : ffi.p50 / native.p50;
+
+  Map<String, dynamic> toJson() => {
+        'id': id,
+        'size': size,
+        'ffi_ns': ffi.toJson(),
+        'native_ns': native.toJson(),
+        'overhead_ns': overheadNs,
+        'ratio': double.parse(ratio.toStringAsFixed(3)),
+        if (size > 0)
+          'ffi_mib_per_s': double.parse(_mibPerSecond(size, ffi.p50)),
+        if (size > 0)
+          'native_mib_per_s': double.parse(_mibPerSecond(size, native.p50)),
+      };
+}
+
+String _mibPerSecond(int size, int ns) =>
+    ns == 0 ? '0' : (size / (1 << 20) / (ns / 1e9)).toStringAsFixed(2);
+
+final _ticksToNs = 1e9 / Stopwatch().frequency;
+
+// Calls [body] once untimed, then until the time budget and at least three
+// calls are done, timing each call.
+_Stats _measure(_Options options, void Function() body) {
+  body();
+  final samples = <int>[];
+  final budget = options.budget.inMicroseconds;
+  final total = Stopwatch()..start();
+  final call = Stopwatch();
+  while (samples.length < 3 || total.elapsedMicroseconds < budget) {
+    call
+      ..reset()
+      ..start();
+    body();
+    call.stop();
+    samples.add((call.elapsedTicks * _ticksToNs).round());
+    if (samples.length >= 1000000) break;
+  }
+  return _Stats(samples..sort());
+}
+
+class _Bench {
+  _Bench(this.options);
+
+  final _Options options;
+  final results = <_Result>[];
+
+  void run(String name, int size, void Function() ffi, void Function() raw) {
+    final id = size > 0 ? '$name/$size' : name;
+    if (options.filter != null && !id.contains(options.filter!)) return;
+    final result = _Result(id, size, _measure(options, ffi),
+        _measure(options, raw));
+    results.add(result);
+    stderr.writeln('  ${id.padRight(34)}'
+        ' ffi ${_us(result.ffi.p50).padLeft(11)}'
+        '  native ${_us(result.native.p50).padLeft(11)}'
+        '  overhead ${_us(result.overheadNs).padLeft(11)}'
+        '  x${result.ratio.toStringAsFixed(2)}');
+  }
+
+  static String _us(int ns) => '${(ns / 1000).toStringAsFixed(1)} us';
+}
+
+// --- Cases -------------------------------------------------------------------
+
+Pointer<Uint8> _copyToNative(Uint8List data) {
+  final ptr = calloc<Uint8>(data.isEmpty ? 1 : data.length);
+  ptr.asTypedList(data.length).setAll(0, data);
+  return ptr;
+}
+
+void _payloadCases(_Bench bench, CryptoFFI ffi, _Native raw, Uint8List data,
+    Uint8List key) {
+  final size = data.length;
+  final dataPtr = _copyToNative(data);
+  final keyPtr = _copyToNative(key);
+
+  // encryptBytes / decryptBytes
+  final encrypted = ffi.encryptBytes(data, key);
+  final encB64 = base64.encode(encrypted).toNativeUtf8(allocator: calloc);
+  bench.run('encryptBytes', size, () => ffi.encryptBytes(data, key), () {
+    raw.freeString(raw.encryptBytes(dataPtr, size, keyPtr, key.length));
+  });
+  bench.run('decryptBytes', size, () => ffi.decryptBytes(encrypted, key), () {
+    raw.freeString(raw.decryptBytes(encB64, keyPtr, key.length));
+  });
+
+  // Base64
+  final b64Len = (size + 2) ~/ 3 * 4;
+  final b64Ptr = calloc<Uint8>(b64Len + 1);
+  final binPtr = calloc<Uint8>(size + 3);
+  raw.base64Encode(dataPtr, size, b64Ptr, b64Len);
+  final text = ffi.base64Encode(data);
+  bench.run('base64Encode', size, () => ffi.base64Encode(data),
+      () => raw.base64Encode(dataPtr, size, b64Ptr, b64Len));
+  bench.run('base64Decode', size, () => ffi.base64Decode(text),
+      () => raw.base64Decode(b64Ptr, b64Len, binPtr, size + 3));
+  // dart:convert for reference: "ffi" is the SDK codec here.
+  bench.run('dartConvertBase64Encode', size, () => base64.encode(data),
+      () => raw.base64Encode(dataPtr, size, b64Ptr, b64Len));
+
+  // Hashing
+  final digestPtr = calloc<Uint8>(32);
+  bench.run('hashBytes', size, () => ffi.hashBytes(data), () {
+    raw.hashBytes(CryptoFFI.hashAlgSha256, dataPtr, size, digestPtr, 32);
+  });
+
+  // Fused container
+  final cap = raw.containerEncryptedSize(size);
+  final outPtr = calloc<Uint8>(cap);
+  final outLenPtr = calloc<IntPtr>();
+  final adPtr = calloc<Uint8>(1);
+  bench.run('encryptAndHash', size, () => ffi.encryptAndHash(data, key), () {
+    raw.encryptBufferHashed(dataPtr, size, keyPtr, key.length, adPtr, 0,
+        CryptoFFI.hashAlgSha256, digestPtr, 32, outPtr, cap, outLenPtr);
+  });
+
+  // Wipe
+  bench.run('secureMemzero', size, () => ffi.secureMemzero(data),
+      () => raw.secureMemzero(dataPtr.cast(), size));
+
+  for (final ptr in [
+    dataPtr, keyPtr, b64Ptr, binPtr, digestPtr, outPtr, adPtr, //
+  ]) {
+    calloc.free(ptr);
+  }
+  calloc.free(outLenPtr);
+  calloc.free(encB64);
+}
+
+void _fixedCases(_Bench bench, CryptoFFI ffi, _Native raw, Random rng) {
+  Uint8List bytes(int n) =>
+      Uint8List.fromList(List.generate(n, (_) => rng.nextInt(256)));
+
+  final master = bytes(32), eph = bytes(32), salt = bytes(16);
+  final masterPtr = _copyToNative(master);
+  final ephPtr = _copyToNative(eph);
+  final saltPtr = _copyToNative(salt);
+  bench.run('deriveSessionKey', 0,
+      () => ffi.deriveSessionKey(master, eph, salt), () {
+    raw.freeString(
+        raw.deriveSessionKey(masterPtr, 32, ephPtr, 32, saltPtr, 16));
+  });
+  calloc.free(masterPtr);
+  calloc.free(ephPtr);
+  calloc.free(saltPtr);
+
+  bench.run('randomBytes/32', 0, () => ffi.randomBytes(32),
+      () => raw.freeString(raw.randomBytesB64(32)));
+
+  const secret = 'JBSWY3DPEHPK3PXP';
+  final otpKey = ffi.createOtpKey(secret);
+  final secretPtr = secret.toNativeUtf8(allocator: calloc);
+  final rawKey = raw.otpKeyNewBase32(CryptoFFI.otpAlgSha1, secretPtr);
+  const now = 1700000000;
+  bench.run('totp', 0, () => otpKey.totp(now),
+      () => raw.totpGenerate(rawKey, now, 30, 6));
+  otpKey.dispose();
+  raw.otpKeyFree(rawKey);
+  calloc.free(secretPtr);
+
+  if (bench.options.quick) return;
+
+  // Argon2 dominates these; the row shows the binding cost is noise.
+  const password = 'correct horse battery staple';
+  final passwordPtr = password.toNativeUtf8(allocator: calloc);
+  final hash = ffi.hashPassword(password);
+  final hashPtr = hash.toNativeUtf8(allocator: calloc);
+  bench.run('hashPassword', 0, () => ffi.hashPassword(password),
+      () => raw.freeString(raw.hashPassword(passwordPtr)));
+  bench.run('verifyPassword', 0, () => ffi.verifyPassword(hash, password),
+      () => raw.verifyPassword(hashPtr, passwordPtr));
+  calloc.free(passwordPtr);
+  calloc.free(hashPtr);
+}
+
+// --- Entry point -------------------------------------------------------------
+
+_Options _parseArgs(List<String> args) {
+  final options = _Options();
+  for (var i = 0; i < args.length; i++) {
+    final value = i + 1 < args.length ? args[i + 1] : null;
+    switch (args[i]) {
+      case '--quick':
+        options.quick = true;
+      case '--filter' when value != null:
+        options.filter = value;
+        i++;
+      case '--min-time' when value != null:
+        options.minTime =
+            Duration(microseconds: (double.parse(value) * 1e6).round());
+        i++;
+      case '--output' when value != null:
+        options.output = value;
+        i++;
+      default:
+        stderr.writeln('usage: crypto_ffi_bench.dart [--quick] '
+            '[--filter TEXT] [--min-time SECONDS] [--output FILE]');
+        exit(2);
+    }
+  }
+  return options;
+}
+
+Future<void> main(List<String> args) async {
+  final options = _parseArgs(args);
+  final ffi = CryptoFFI();
+  // Both run in the background from the constructor; keep them out of the
+  // measurements.
+  await ffi.warmup;
+  await ffi.libraryIntegrity;
+  final raw = _Native(DynamicLibrary.open('libnative_crypto_library.so'));
+
+  final rng = Random(42);
+  final key = Uint8List.fromList(List.generate(32, (_) => rng.nextInt(256)));
+  final sizes = options.quick
+      ? const [64, 1024, 64 * 1024]
+      : const [64, 1024, 64 * 1024, 1 << 20, 16 << 20];
+
+  final bench = _Bench(options);
+  for (final size in sizes) {
+    stderr.writeln('payload $size B');
+    final data =
+        Uint8List.fromList(List.generate(size, (_) => rng.nextInt(256)));
+    _payloadCases(bench, ffi, raw, data, key);
+  }
+  stderr.writeln('fixed-size');
+  _fixedCases(bench, ffi, raw, rng);
+
+  final output = options.output;
+  if (output != null) {
+    final json = const JsonEncoder.withIndent('  ').convert({
+      'schema': 1,
+      'library': 'crypto_ffi',
+      'dart': Platform.version,
+      'timestamp': DateTime.now().millisecondsSinceEpoch ~/ 1000,
+      'quick': options.quick,
+      'peak_rss_kib': ProcessInfo.maxRss >> 10,
+      'results': [for (final r in bench.results) r.toJson()],
+    });
+    await File(output).writeAsString('$json\n');
+  }
+}
@@ -8,6 +8,7 @@ import 'package:notehider/features/authentication/bloc/auth_bloc.dart';
 import 'package:notehider/homepage.dart';
 import 'package:notehider/bloc/tab_bloc.dart';
 import 'package:notehider/features/notes/bloc/notes_bloc.dart';
+import 'package:notehider/services/crypto_ffi.dart';
 import 'package:notehider/services/crypto_service.dart';
 import 'package:notehider/services/storage_service.dart';
 import 'package:notehider/services/security_config_service.dart';
@@ -38,8 +39,13 @@ void main() async {
     DeviceOrientation.portraitDown,
   ]);
 
-  // Initialize core services
+  // Initialize core services. Creating CryptoService loads the native
+  // library; the crypto warm-up starts on a background thread once the
+  // library has passed its checksum check.
   final cryptoService = CryptoService();
+  CryptoFFI().warmup.then((warmup) {
+    if (warmup != null) print('⚡ Native crypto warm-up: ${warmup.toJson()}');
+  });
   final storageService = StorageService(cryptoService: cryptoService);
   final securityConfigService = SecurityConfigService(
     storageService: storageService,
@@ -7,10 +7,13 @@
 /// • Multi-level wipe methods
 /// • Panic mode activation
 
+import 'package:flutter/foundation.dart';
 import 'package:flutter_secure_storage/flutter_secure_storage.dart';
 import 'package:notehider/models/security_config.dart';
 import 'package:notehider/services/storage_service.dart';
 import 'package:notehider/services/crypto_service.dart';
+import 'package:notehider/services/crypto_ffi.dart';
+import 'package:notehider/services/file_manager_service.dart';
 import 'dart:convert';
 import 'dart:io';
 import 'dart:math';
@@ -49,6 +52,10 @@ class AutoWipeService {
   static const int _maxHistorySize = 50;
   static const Duration _failedAttemptWindow = Duration(hours: 24);
 
+  // After this, the native wipe drops extra passes (each file still gets
+  // one full pass) so a panic wipe of a large vault cannot stall.
+  static const Duration _fileWipeDeadline = Duration(seconds: 30);
+
   AutoWipeService({
     required StorageService storageService,
     required CryptoService cryptoService,
@@ -396,9 +403,17 @@ class AutoWipeService {
   }
 
   Future<void> _wipeFiles() async {
-    // Clear all file metadata
-    // FileManagerService will handle actual file deletion in integration
-    print('🗑️ File metadata prepared for wipe');
+    // One random pass, then drop the metadata that points at the files
+    final wiped = await _secureWipeVault(1);
+
+    for (final key in ['file_manager_metadata', 'file_manager_stats']) {
+      try {
+        await _secureStorage.delete(key: key);
+      } catch (e) {
+        print('⚠️ Failed to clear file metadata $key: $e');
+      }
+    }
+    print('🗑️ Files wiped ($wiped files)');
   }
 
   Future<void> _wipeCredentials() async {
@@ -442,17 +457,37 @@ class AutoWipeService {
   }
 
   Future<void> _overwriteData(int passes) async {
-    // Overwrite data multiple times with random data
-    final random = Random.secure();
-
-    for (int i = 0; i < passes; i++) {
-      final randomData = List.generate(1024, (_) => random.nextInt(256));
+    // Overwrite every vault file in place before it is unlinked
+    final wiped = await _secureWipeVault(passes);
+    print('🗑️ Data overwritten ($passes passes, $wiped files)');
+  }
 
-      // This would overwrite actual data files in production
-      // For now, we'll simulate the process
-      await Future.delayed(Duration(milliseconds: 10));
+  /// Overwrites, truncates and unlinks every `.enc` file and thumbnail in
+  /// the vault on a background isolate. Returns the number of files
+  /// removed; throws if any file survived.
+  Future<int> _secureWipeVault(int passes) async {
+    final dir = await FileManagerService.secureDirectory();
+    if (!await dir.exists()) return 0;
+
+    final paths = await dir
+        .list(recursive: true, followLinks: false)
+        .where((entity) => entity is! Directory)
+        .map((entity) => entity.path)
+        .toList();
+    if (paths.isEmpty) return 0;
+
+    final results = await compute(_secureWipeWorker, {
+      'paths': paths,
+      'passes': passes.clamp(1, CryptoFFI.wipeMaxPasses),
+      'deadlineMs': _fileWipeDeadline.inMilliseconds,
+    });
+
+    final failed =
+        results.where((r) => r == CryptoFFI.wipeResultFailed).length;
+    if (failed > 0) {
+      throw StateError('$failed of ${paths.length} vault files not wiped');
     }
-    print('🗑️ Data overwritten ($passes passes)');
+    return results.where((r) => r != CryptoFFI.wipeResultMissing).length;
   }
 
   Future<void> _wipeEncryptionKeys() async {
@@ -1049,3 +1084,17 @@ class WipeMethodResult {
     );
   }
 }
+
+// ---------------------------------------------------------------------------
+// Isolate helpers (must live at top-level)
+// ---------------------------------------------------------------------------
+
+// The native wipe blocks until every file is gone, so it runs off the UI
+// isolate.
+List<int> _secureWipeWorker(Map<String, dynamic> data) {
+  return CryptoFFI().secureWipeFiles(
+    (data['paths'] as List).cast<String>(),
+    passes: data['passes'] as int,
+    deadline: Duration(milliseconds: data['deadlineMs'] as int),
+  );
+}
@@ -1,6 +1,7 @@
+import 'dart:async';
 import 'dart:ffi';
 import 'dart:io';
-import 'dart:convert';
+import 'dart:isolate';
 import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
@@ -40,9 +41,19 @@ typedef _DecryptBytesC = Pointer<Utf8> Function(
 typedef _DecryptBytesDart = Pointer<Utf8> Function(
     Pointer<Utf8> cipher, Pointer<Uint8> key, int keyLen);
 
+// Same as above, with authenticated (not encrypted) associated data
+typedef _EncryptBytesAdC = Pointer<Utf8> Function(Pointer<Uint8> data,
+    IntPtr dataLen, Pointer<Uint8> key, IntPtr keyLen, Pointer<Uint8> ad,
+    IntPtr adLen);
+typedef _EncryptBytesAdDart = Pointer<Utf8> Function(Pointer<Uint8> data,
+    int dataLen, Pointer<Uint8> key, int keyLen, Pointer<Uint8> ad, int adLen);
+
+typedef _DecryptBytesAdC = Pointer<Utf8> Function(Pointer<Utf8> cipher,
+    Pointer<Uint8> key, IntPtr keyLen, Pointer<Uint8> ad, IntPtr adLen);
+typedef _DecryptBytesAdDart = Pointer<Utf8> Function(Pointer<Utf8> cipher,
+    Pointer<Uint8> key, int keyLen, Pointer<Uint8> ad, int adLen);
+
 // Native random bytes base64
-typedef _RandomBytesB64C = Pointer<Utf8> Function(IntPtr len);
-typedef _RandomBytesB64Dart = Pointer<Utf8> Function(int len);
 
 // Native HKDF session key derivation – returns base64 key
 typedef _DeriveSessionKeyB64C = Pointer<Utf8> Function(
@@ -73,27 +84,284 @@ typedef _Pbkdf2B64Dart = Pointer<Utf8> Function(
 typedef _SecureMemzeroC = Void Function(Pointer<Uint8> data, IntPtr dataLen);
 typedef _SecureMemzeroDart = void Function(Pointer<Uint8> data, int dataLen);
 
+// Native incremental hashing (SHA-256 / BLAKE2b)
+typedef _HashCtxNewC = Pointer<Void> Function(Int32 alg, IntPtr digestLen);
+typedef _HashCtxNewDart = Pointer<Void> Function(int alg, int digestLen);
+
+typedef _HashCtxUpdateC = Int32 Function(
+    Pointer<Void> ctx, Pointer<Uint8> data, IntPtr len);
+typedef _HashCtxUpdateDart = int Function(
+    Pointer<Void> ctx, Pointer<Uint8> data, int len);
+
+typedef _HashCtxFinalC = Int32 Function(
+    Pointer<Void> ctx, Pointer<Uint8> out, IntPtr outLen);
+typedef _HashCtxFinalDart = int Function(
+    Pointer<Void> ctx, Pointer<Uint8> out, int outLen);
+
+typedef _HashCtxFreeC = Void Function(Pointer<Void> ctx);
+typedef _HashCtxFreeDart = void Function(Pointer<Void> ctx);
+
+typedef _HashBytesC = Int32 Function(Int32 alg, Pointer<Uint8> data,
+    IntPtr len, Pointer<Uint8> out, IntPtr outLen);
+typedef _HashBytesDart = int Function(
+    int alg, Pointer<Uint8> data, int len, Pointer<Uint8> out, int outLen);
+
+typedef _HashFileC = Int32 Function(
+    Int32 alg, Pointer<Utf8> path, Pointer<Uint8> out, IntPtr outLen);
+typedef _HashFileDart = int Function(
+    int alg, Pointer<Utf8> path, Pointer<Uint8> out, int outLen);
+
+// Fused encrypt-and-hash container (single pass)
+typedef _ContainerSetAeadC = Int32 Function(Int32 aead);
+typedef _ContainerSetAeadDart = int Function(int aead);
+
+typedef _ContainerSelectedAeadC = Int32 Function();
+typedef _ContainerSelectedAeadDart = int Function();
+
+typedef _ContainerAeadAvailableC = Int32 Function(Int32 aead);
+typedef _ContainerAeadAvailableDart = int Function(int aead);
+
+typedef _ContainerEncryptedSizeC = IntPtr Function(IntPtr plainLen);
+typedef _ContainerEncryptedSizeDart = int Function(int plainLen);
+
+typedef _BufferHashedC = Int32 Function(
+    Pointer<Uint8> data,
+    IntPtr len,
+    Pointer<Uint8> key,
+    IntPtr keyLen,
+    Pointer<Uint8> ad,
+    IntPtr adLen,
+    Int32 hashAlg,
+    Pointer<Uint8> digest,
+    IntPtr digestLen,
+    Pointer<Uint8> out,
+    IntPtr outCap,
+    Pointer<IntPtr> outLen);
+typedef _BufferHashedDart = int Function(
+    Pointer<Uint8> data,
+    int len,
+    Pointer<Uint8> key,
+    int keyLen,
+    Pointer<Uint8> ad,
+    int adLen,
+    int hashAlg,
+    Pointer<Uint8> digest,
+    int digestLen,
+    Pointer<Uint8> out,
+    int outCap,
+    Pointer<IntPtr> outLen);
+
+typedef _FileHashedC = Int32 Function(
+    Pointer<Utf8> inPath,
+    Pointer<Utf8> outPath,
+    Pointer<Uint8> key,
+    IntPtr keyLen,
+    Pointer<Uint8> ad,
+    IntPtr adLen,
+    Int32 hashAlg,
+    Pointer<Uint8> digest,
+    IntPtr digestLen);
+typedef _FileHashedDart = int Function(
+    Pointer<Utf8> inPath,
+    Pointer<Utf8> outPath,
+    Pointer<Uint8> key,
+    int keyLen,
+    Pointer<Uint8> ad,
+    int adLen,
+    int hashAlg,
+    Pointer<Uint8> digest,
+    int digestLen);
+
+// One-time passwords (HOTP/TOTP)
+typedef _OtpKeyNewBase32C = Pointer<Void> Function(
+    Int32 alg, Pointer<Utf8> secretB32);
+typedef _OtpKeyNewBase32Dart = Pointer<Void> Function(
+    int alg, Pointer<Utf8> secretB32);
+
+typedef _OtpKeyFreeC = Void Function(Pointer<Void> key);
+typedef _OtpKeyFreeDart = void Function(Pointer<Void> key);
+
+typedef _TotpGenerateC = Int64 Function(
+    Pointer<Void> key, Uint64 unixTime, Uint32 step, Int32 digits);
+typedef _TotpGenerateDart = int Function(
+    Pointer<Void> key, int unixTime, int step, int digits);
+
+typedef _TotpVerifyC = Int32 Function(Pointer<Void> key, Uint64 unixTime,
+    Uint32 step, Int32 digits, Uint64 code, Uint32 window,
+    Pointer<Int32> matchedOffset);
+typedef _TotpVerifyDart = int Function(Pointer<Void> key, int unixTime,
+    int step, int digits, int code, int window, Pointer<Int32> matchedOffset);
+
+// Native Base64 / Base32 codecs (caller-provided buffers). Encoders take
+// bytes and write ASCII; decoders the reverse. Both return the number of
+// bytes written or -1.
+typedef _CodecC = Int64 Function(
+    Pointer<Uint8> input, IntPtr inLen, Pointer<Uint8> out, IntPtr outCap);
+typedef _CodecDart = int Function(
+    Pointer<Uint8> input, int inLen, Pointer<Uint8> out, int outCap);
+
+typedef _Base32EncodeC = Int64 Function(Pointer<Uint8> input, IntPtr inLen,
+    Pointer<Uint8> out, IntPtr outCap, Int32 pad);
+typedef _Base32EncodeDart = int Function(
+    Pointer<Uint8> input, int inLen, Pointer<Uint8> out, int outCap, int pad);
+
+// Native multi-pass secure file wipe (blocking, multi-threaded)
+typedef _SecureWipeFilesC = Int32 Function(
+    Pointer<Pointer<Utf8>> paths,
+    IntPtr count,
+    Uint32 passes,
+    Uint32 flags,
+    Uint32 threads,
+    Uint32 deadlineMs,
+    Pointer<Int8> results);
+typedef _SecureWipeFilesDart = int Function(
+    Pointer<Pointer<Utf8>> paths,
+    int count,
+    int passes,
+    int flags,
+    int threads,
+    int deadlineMs,
+    Pointer<Int8> results);
+
+// Library self-check: the native side hashes its own mapped read-only
+// segments on a background thread and reports through the callback.
+typedef _SelfCheckCallbackC = Void Function(
+    Int64 covered, Pointer<Uint8> digest, Uint64 elapsedNs);
+typedef _SelfCheckAsyncC = Int32 Function(
+    Pointer<NativeFunction<_SelfCheckCallbackC>> cb);
+typedef _SelfCheckAsyncDart = int Function(
+    Pointer<NativeFunction<_SelfCheckCallbackC>> cb);
+typedef _SelfCheckFreeC = Void Function(Pointer<Uint8> digest);
+typedef _SelfCheckFreeDart = void Function(Pointer<Uint8> digest);
+
+// Startup warm-up: runs on a native background thread and reports through
+// the callback (immediately if the runner already finished it).
+typedef _WarmupCallbackC = Void Function(Pointer<_NativeWarmupReport> report);
+typedef _WarmupStartC = Int32 Function(
+    Uint32 flags, Pointer<NativeFunction<_WarmupCallbackC>> cb);
+typedef _WarmupStartDart = int Function(
+    int flags, Pointer<NativeFunction<_WarmupCallbackC>> cb);
+
+// Native call statistics (native_stats.h)
+typedef _StatsSnapshotC = Int32 Function(Pointer<_NativeStatsSnapshot> out);
+typedef _StatsSnapshotDart = int Function(Pointer<_NativeStatsSnapshot> out);
+typedef _StatsResetC = Void Function();
+typedef _StatsResetDart = void Function();
+typedef _StatsNameC = Pointer<Utf8> Function(Uint32 fn);
+typedef _StatsNameDart = Pointer<Utf8> Function(int fn);
+
+// Secure memory pool (native_secmem.h)
+typedef _SecmemReportC = Int32 Function(Pointer<_NativeSecmemReport> out);
+typedef _SecmemReportDart = int Function(Pointer<_NativeSecmemReport> out);
+
+// Per-thread scratch arena (native_scratch.h)
+typedef _ScratchAllocC = Pointer<Uint8> Function(IntPtr len);
+typedef _ScratchAllocDart = Pointer<Uint8> Function(int len);
+typedef _ScratchMarkC = Uint64 Function();
+typedef _ScratchMarkDart = int Function();
+typedef _ScratchReleaseC = Void Function(Uint64 mark);
+typedef _ScratchReleaseDart = void Function(int mark);
+
+// Buffered CSPRNG (native_rng.h)
+typedef _RngFillC = Int32 Function(Pointer<Uint8> buf, IntPtr len);
+typedef _RngFillDart = int Function(Pointer<Uint8> buf, int len);
+
+// Span tracing (native_trace.h)
+typedef _TraceStartC = Int64 Function(Uint32 capacity);
+typedef _TraceStartDart = int Function(int capacity);
+typedef _TraceStopC = Void Function();
+typedef _TraceStopDart = void Function();
+typedef _TraceDumpJsonC = Pointer<Utf8> Function(Int32 clear);
+typedef _TraceDumpJsonDart = Pointer<Utf8> Function(int clear);
+
 /// A class to encapsulate the FFI calls to our native crypto library.
 class CryptoFFI {
+  // Hash algorithm identifiers – must match HASH_ALG_* in native_crypto.h.
+  static const int hashAlgSha256 = 1;
+  static const int hashAlgBlake2b = 2;
+
   // Singleton pattern to ensure the library is loaded only once.
   static final CryptoFFI _instance = CryptoFFI._internal();
   factory CryptoFFI() => _instance;
 
   late final DynamicLibrary _dylib;
+  String? _dylibPath;
   late final _GetLibsodiumVersionStringDart _getLibsodiumVersionString;
   late final _HashPasswordDart _hashPassword;
   late final _VerifyPasswordDart _verifyPassword;
   late final _FreeStringDart _freeString;
   late final _EncryptBytesDart _encryptBytes;
   late final _DecryptBytesDart _decryptBytes;
-  late final _RandomBytesB64Dart _randomBytesB64;
+  late final _EncryptBytesAdDart _encryptBytesAd;
+  late final _DecryptBytesAdDart _decryptBytesAd;
   late final _DeriveSessionKeyB64Dart _deriveSessionKeyB64;
   late final _Pbkdf2B64Dart _pbkdf2B64;
   late final _SecureMemzeroDart _secureMemzero;
+  late final _HashCtxNewDart _hashCtxNew;
+  late final _HashCtxUpdateDart _hashCtxUpdate;
+  late final _HashCtxFinalDart _hashCtxFinal;
+  late final _HashCtxFreeDart _hashCtxFree;
+  late final _HashBytesDart _hashBytes;
+  late final _HashFileDart _hashFile;
+  late final _ContainerSetAeadDart _containerSetAead;
+  late final _ContainerSelectedAeadDart _containerSelectedAead;
+  late final _ContainerAeadAvailableDart _containerAeadAvailable;
+  late final _ContainerEncryptedSizeDart _containerEncryptedSize;
+  late final _BufferHashedDart _encryptBufferHashed;
+  late final _BufferHashedDart _decryptBufferHashed;
+  late final _FileHashedDart _encryptFileHashed;
+  late final _FileHashedDart _decryptFileHashed;
+  late final _OtpKeyNewBase32Dart _otpKeyNewBase32;
+  late final _OtpKeyFreeDart _otpKeyFree;
+  late final _TotpGenerateDart _totpGenerate;
+  late final _TotpVerifyDart _totpVerify;
+  late final _CodecDart _base64Encode;
+  late final _CodecDart _base64Decode;
+  late final _Base32EncodeDart _base32Encode;
+  late final _CodecDart _base32Decode;
+  late final _SecureWipeFilesDart _secureWipeFiles;
+  late final _SelfCheckAsyncDart _selfCheckAsync;
+  late final _SelfCheckFreeDart _selfCheckFree;
+  late final _WarmupStartDart _warmupStart;
+  late final _StatsSnapshotDart _statsSnapshot;
+  late final _StatsResetDart _statsReset;
+  late final _StatsNameDart _statsName;
+  late final _SecmemReportDart _secmemReport;
+  late final _ScratchAllocDart _scratchAlloc;
+  late final _ScratchMarkDart _scratchMark;
+  late final _ScratchReleaseDart _scratchRelease;
+  late final _RngFillDart _rngFill;
+  late final _TraceStartDart _traceStart;
+  late final _TraceStopDart _traceStop;
+  late final _TraceDumpJsonDart _traceDumpJson;
+
+  /// Allocator for per-call temporaries; only valid inside [_withScratch].
+  late final Allocator _scratch = _ScratchAllocator(_scratchAlloc);
+
+  /// Result of checking the loaded library against the checksum pinned on
+  /// first launch. Runs in the background from the constructor; startup
+  /// never waits for it, key derivation does ([ensureLibraryIntact]).
+  late final Future<LibrarySelfCheck> libraryIntegrity;
+
+  /// Outcome of the checksum check once known; null while it runs. Mobile
+  /// and a first-run pin count as intact.
+  bool? _libraryIntact;
+
+  /// Timings of the native warm-up (libsodium init, KDF parameter
+  /// selection, CPU probes), started as soon as [libraryIntegrity] has
+  /// passed so the first unlock finds everything initialised. Null if the
+  /// library failed the check or the warm-up could not start.
+  late final Future<CryptoWarmup?> warmup;
 
   CryptoFFI._internal() {
     _dylib = _loadDylib();
     _initializeFunctions();
+    // 🔒 Verify integrity of the native binary off the startup path; no
+    // library code runs before it has passed.
+    libraryIntegrity = _verifyLibrary();
+    // ⚡ Pay libsodium / Argon2 cold-start costs before the unlock screen.
+    warmup = libraryIntegrity.then(
+        (_) => _libraryIntact == true ? _startWarmup() : Future.value(null));
     print("Native crypto library loaded.");
   }
 
@@ -126,10 +394,15 @@ class CryptoFFI {
         .lookup<NativeFunction<_DecryptBytesC>>('decrypt_bytes')
         .asFunction<_DecryptBytesDart>();
 
+    _encryptBytesAd = _dylib
+        .lookup<NativeFunction<_EncryptBytesAdC>>('encrypt_bytes_ad')
+        .asFunction<_EncryptBytesAdDart>();
+
+    _decryptBytesAd = _dylib
+        .lookup<NativeFunction<_DecryptBytesAdC>>('decrypt_bytes_ad')
+        .asFunction<_DecryptBytesAdDart>();
+
     // --- New helpers ---
-    _randomBytesB64 = _dylib
-        .lookup<NativeFunction<_RandomBytesB64C>>('random_bytes_b64')
-        .asFunction<_RandomBytesB64Dart>();
 
     _deriveSessionKeyB64 = _dylib
         .lookup<NativeFunction<_DeriveSessionKeyB64C>>('derive_session_key_b64')
@@ -143,6 +416,163 @@ class CryptoFFI {
     _secureMemzero = _dylib
         .lookup<NativeFunction<_SecureMemzeroC>>('secure_memzero')
         .asFunction<_SecureMemzeroDart>();
+
+    // Native hashing
+    _hashCtxNew = _dylib
+        .lookup<NativeFunction<_HashCtxNewC>>('hash_ctx_new')
+        .asFunction<_HashCtxNewDart>();
+
+    _hashCtxUpdate = _dylib
+        .lookup<NativeFunction<_HashCtxUpdateC>>('hash_ctx_update')
+        .asFunction<_HashCtxUpdateDart>();
+
+    _hashCtxFinal = _dylib
+        .lookup<NativeFunction<_HashCtxFinalC>>('hash_ctx_final')
+        .asFunction<_HashCtxFinalDart>();
+
+    _hashCtxFree = _dylib
+        .lookup<NativeFunction<_HashCtxFreeC>>('hash_ctx_free')
+        .asFunction<_HashCtxFreeDart>();
+
+    _hashBytes = _dylib
+        .lookup<NativeFunction<_HashBytesC>>('hash_bytes')
+        .asFunction<_HashBytesDart>();
+
+    _hashFile = _dylib
+        .lookup<NativeFunction<_HashFileC>>('hash_file')
+        .asFunction<_HashFileDart>();
+
+    // Fused encrypt-and-hash container
+    _containerSetAead = _dylib
+        .lookup<NativeFunction<_ContainerSetAeadC>>('container_set_aead')
+        .asFunction<_ContainerSetAeadDart>();
+
+    _containerSelectedAead = _dylib
+        .lookup<NativeFunction<_ContainerSelectedAeadC>>(
+            'container_selected_aead')
+        .asFunction<_ContainerSelectedAeadDart>();
+
+    _containerAeadAvailable = _dylib
+        .lookup<NativeFunction<_ContainerAeadAvailableC>>(
+            'container_aead_available')
+        .asFunction<_ContainerAeadAvailableDart>();
+
+    _containerEncryptedSize = _dylib
+        .lookup<NativeFunction<_ContainerEncryptedSizeC>>(
+            'container_encrypted_size')
+        .asFunction<_ContainerEncryptedSizeDart>();
+
+    _encryptBufferHashed = _dylib
+        .lookup<NativeFunction<_BufferHashedC>>('encrypt_buffer_hashed')
+        .asFunction<_BufferHashedDart>();
+
+    _decryptBufferHashed = _dylib
+        .lookup<NativeFunction<_BufferHashedC>>('decrypt_buffer_hashed')
+        .asFunction<_BufferHashedDart>();
+
+    _encryptFileHashed = _dylib
+        .lookup<NativeFunction<_FileHashedC>>('encrypt_file_hashed')
+        .asFunction<_FileHashedDart>();
+
+    _decryptFileHashed = _dylib
+        .lookup<NativeFunction<_FileHashedC>>('decrypt_file_hashed')
+        .asFunction<_FileHashedDart>();
+
+    // One-time passwords
+    _otpKeyNewBase32 = _dylib
+        .lookup<NativeFunction<_OtpKeyNewBase32C>>('otp_key_new_base32')
+        .asFunction<_OtpKeyNewBase32Dart>();
+
+    _otpKeyFree = _dylib
+        .lookup<NativeFunction<_OtpKeyFreeC>>('otp_key_free')
+        .asFunction<_OtpKeyFreeDart>();
+
+    _totpGenerate = _dylib
+        .lookup<NativeFunction<_TotpGenerateC>>('totp_generate')
+        .asFunction<_TotpGenerateDart>();
+
+    _totpVerify = _dylib
+        .lookup<NativeFunction<_TotpVerifyC>>('totp_verify')
+        .asFunction<_TotpVerifyDart>();
+
+    // Base64 / Base32 codecs
+    _base64Encode = _dylib
+        .lookup<NativeFunction<_CodecC>>('base64_encode')
+        .asFunction<_CodecDart>();
+
+    _base64Decode = _dylib
+        .lookup<NativeFunction<_CodecC>>('base64_decode')
+        .asFunction<_CodecDart>();
+
+    _base32Encode = _dylib
+        .lookup<NativeFunction<_Base32EncodeC>>('base32_encode')
+        .asFunction<_Base32EncodeDart>();
+
+    _base32Decode = _dylib
+        .lookup<NativeFunction<_CodecC>>('base32_decode')
+        .asFunction<_CodecDart>();
+
+    // Secure file wipe
+    _secureWipeFiles = _dylib
+        .lookup<NativeFunction<_SecureWipeFilesC>>('secure_wipe_files')
+        .asFunction<_SecureWipeFilesDart>();
+
+    // Library self-check
+    _selfCheckAsync = _dylib
+        .lookup<NativeFunction<_SelfCheckAsyncC>>(
+            'integrity_self_check_async')
+        .asFunction<_SelfCheckAsyncDart>();
+    _selfCheckFree = _dylib
+        .lookup<NativeFunction<_SelfCheckFreeC>>('integrity_self_check_free')
+        .asFunction<_SelfCheckFreeDart>();
+
+    // Startup warm-up
+    _warmupStart = _dylib
+        .lookup<NativeFunction<_WarmupStartC>>('native_crypto_warmup_start')
+        .asFunction<_WarmupStartDart>();
+
+    // Call statistics
+    _statsSnapshot = _dylib
+        .lookup<NativeFunction<_StatsSnapshotC>>('native_crypto_stats')
+        .asFunction<_StatsSnapshotDart>();
+    _statsReset = _dylib
+        .lookup<NativeFunction<_StatsResetC>>('native_crypto_stats_reset')
+        .asFunction<_StatsResetDart>();
+    _statsName = _dylib
+        .lookup<NativeFunction<_StatsNameC>>('native_crypto_stats_name')
+        .asFunction<_StatsNameDart>();
+
+    // Secure memory pool
+    _secmemReport = _dylib
+        .lookup<NativeFunction<_SecmemReportC>>('secmem_report_fill')
+        .asFunction<_SecmemReportDart>();
+
+    // Scratch arena (leaf calls: no callbacks, a few ns each)
+    _scratchAlloc = _dylib
+        .lookup<NativeFunction<_ScratchAllocC>>('scratch_alloc')
+        .asFunction<_ScratchAllocDart>(isLeaf: true);
+    _scratchMark = _dylib
+        .lookup<NativeFunction<_ScratchMarkC>>('scratch_mark')
+        .asFunction<_ScratchMarkDart>(isLeaf: true);
+    _scratchRelease = _dylib
+        .lookup<NativeFunction<_ScratchReleaseC>>('scratch_release')
+        .asFunction<_ScratchReleaseDart>(isLeaf: true);
+
+    // Buffered CSPRNG
+    _rngFill = _dylib
+        .lookup<NativeFunction<_RngFillC>>('rng_fill')
+        .asFunction<_RngFillDart>();
+
+    // Span tracing
+    _traceStart = _dylib
+        .lookup<NativeFunction<_TraceStartC>>('native_trace_start')
+        .asFunction<_TraceStartDart>();
+    _traceStop = _dylib
+        .lookup<NativeFunction<_TraceStopC>>('native_trace_stop')
+        .asFunction<_TraceStopDart>();
+    _traceDumpJson = _dylib
+        .lookup<NativeFunction<_TraceDumpJsonC>>('native_trace_dump_json')
+        .asFunction<_TraceDumpJsonDart>();
   }
 
   /// Loads the dynamic library from the correct path based on the platform.
@@ -163,45 +593,214 @@ class CryptoFFI {
       throw UnsupportedError('Unsupported platform for FFI');
     }
 
-    // 🔒 Verify integrity of the native binary before loading it.
-    _verifyDylibChecksum(path);
-
+    _dylibPath = path;
     return DynamicLibrary.open(path);
   }
 
-  /// Computes SHA-256 of the dynamic library on disk. On first run we write a
-  /// side-car file `<lib>.sha256`. Subsequent launches compare against the
-  /// stored value and abort if it differs (indicating possible tampering).
-  void _verifyDylibChecksum(String dylibPath) {
+  /// Computes SHA-256 of the dynamic library on disk in a background
+  /// isolate and compares it with the pin in `<lib>.sha256` (written on
+  /// first run). A mismatch, or a library that cannot be hashed, counts as
+  /// tampering. The hash is taken in Dart so the library never vouches for
+  /// itself; the native in-memory digest is only taken once the file has
+  /// passed, and only reported alongside.
+  Future<LibrarySelfCheck> _verifyLibrary() async {
+    final stopwatch = Stopwatch()..start();
+
     // On mobile platforms the library lives inside the app sandbox at a
     // runtime-determined path that File() can't access via a simple relative
     // name. We keep the checksum lock for desktop platforms where the path is
     // predictable. Mobile integrity is instead covered by Play Integrity /
     // App Attest.
-    if (Platform.isIOS || Platform.isAndroid) return;
-
-    final file = File(dylibPath);
-    if (!file.existsSync()) {
-      throw StateError('Native library not found at $dylibPath');
+    final dylibPath = _dylibPath;
+    if (Platform.isIOS || Platform.isAndroid || dylibPath == null) {
+      _libraryIntact ??= true;
+      return LibrarySelfCheck(
+          null, await _nativeSelfDigest(), stopwatch.elapsed, null);
     }
 
-    final bytes = file.readAsBytesSync();
-    final currentHash = sha256.convert(bytes).toString();
+    String? digest;
+    bool? matches;
+    try {
+      digest = await _fileChecksumInBackground(dylibPath);
+      matches = _compareWithPin(dylibPath, digest);
+    } catch (e) {
+      print('🚨 Native library checksum could not be verified: $e');
+      matches = false;
+    }
+    _libraryIntact ??= matches != false;
+    final memoryDigest =
+        _libraryIntact == true ? await _nativeSelfDigest() : null;
+    return LibrarySelfCheck(digest, memoryDigest, stopwatch.elapsed, matches);
+  }
 
+  /// Compares [digest] with the pin next to the library. Returns null after
+  /// pinning it on first run.
+  static bool? _compareWithPin(String dylibPath, String digest) {
     final checksumFile = File('$dylibPath.sha256');
     if (!checksumFile.existsSync()) {
       // First launch: persist checksum lock-file next to the library.
-      checksumFile.writeAsStringSync(currentHash, flush: true);
-      return;
+      checksumFile.writeAsStringSync(digest, flush: true);
+      return null;
+    }
+    final storedHash = checksumFile.readAsStringSync().trim();
+    if (storedHash != digest) {
+      print('🚨 Native library checksum mismatch – expected $storedHash, '
+          'got $digest. Possible tampering detected.');
+      return false;
+    }
+    return true;
+  }
+
+  /// The same check on the calling thread, for a first use that arrives
+  /// before the background check has finished.
+  bool _verifyLibrarySync() {
+    final dylibPath = _dylibPath;
+    if (Platform.isIOS || Platform.isAndroid || dylibPath == null) return true;
+    try {
+      final digest =
+          sha256.convert(File(dylibPath).readAsBytesSync()).toString();
+      return _compareWithPin(dylibPath, digest) != false;
+    } catch (e) {
+      print('🚨 Native library checksum could not be verified: $e');
+      return false;
+    }
+  }
+
+  /// Throws [StateError] unless the library has passed the checksum check.
+  /// Every operation that hands keys, passwords, plaintext or randomness to
+  /// native code calls this first (via [_withScratch] for most of them), so
+  /// no such call precedes the check: if the background check is still
+  /// running, the file is hashed here instead.
+  void _requireIntactLibrary() {
+    final intact = _libraryIntact ??= _verifyLibrarySync();
+    if (!intact) {
+      throw StateError('Native library checksum mismatch. '
+          'Possible tampering detected.');
     }
+  }
+
+  /// Waits for [libraryIntegrity] and throws [StateError] if the library
+  /// failed it. Lets async callers (unlock, key derivation) wait for the
+  /// background check instead of hashing the file on their own thread.
+  Future<void> ensureLibraryIntact() async {
+    await libraryIntegrity;
+    _requireIntactLibrary();
+  }
+
+  /// Digest of the mapped library from the native background thread, or
+  /// null where the platform cannot enumerate loaded segments.
+  Future<String?> _nativeSelfDigest() {
+    final completer = Completer<String?>();
+    late final NativeCallable<_SelfCheckCallbackC> callable;
+    callable = NativeCallable<_SelfCheckCallbackC>.listener(
+        (int covered, Pointer<Uint8> digest, int elapsedNs) {
+      String? result;
+      if (covered >= 0) {
+        final hex = digest
+            .asTypedList(32)
+            .map((b) => b.toRadixString(16).padLeft(2, '0'))
+            .join();
+        result = 'blake2b-mem:$hex';
+      }
+      // Each call gets its own digest block; release it once copied.
+      _selfCheckFree(digest);
+      callable.close();
+      completer.complete(result);
+    });
+    if (_selfCheckAsync(callable.nativeFunction) != 0) {
+      callable.close();
+      return Future.value(null);
+    }
+    return completer.future;
+  }
+
+  Future<CryptoWarmup?> _startWarmup() {
+    final completer = Completer<CryptoWarmup?>();
+    late final NativeCallable<_WarmupCallbackC> callable;
+    callable = NativeCallable<_WarmupCallbackC>.listener(
+        (Pointer<_NativeWarmupReport> report) {
+      // The native report is static and never freed.
+      final r = report.ref;
+      callable.close();
+      completer.complete(r.version == _warmupReportVersion
+          ? CryptoWarmup._fromNative(r)
+          : null);
+    });
+    if (_warmupStart(0, callable.nativeFunction) != 0) {
+      callable.close();
+      return Future.value(null);
+    }
+    return completer.future;
+  }
+
+  /// Per-function call counts, bytes and latency/size histograms collected
+  /// inside the native library since the first call or [resetNativeStats].
+  /// Functions that have not been called are omitted.
+  NativeCryptoStats nativeStats() {
+    final snapshot = calloc<_NativeStatsSnapshot>();
+    try {
+      _statsSnapshot(snapshot);
+      final s = snapshot.ref;
+      if (s.version != _statsSnapshotVersion) {
+        return NativeCryptoStats(false, Duration.zero, const []);
+      }
+      final functions = <NativeCallStats>[];
+      for (var i = 0; i < s.fnCount && i < _statsFnCount; i++) {
+        final fn = s.fns[i];
+        if (fn.calls == 0) continue;
+        functions.add(NativeCallStats._fromNative(
+            _statsName(i).toDartString(), fn));
+      }
+      return NativeCryptoStats(s.enabled != 0,
+          Duration(microseconds: s.windowNs ~/ 1000), functions);
+    } finally {
+      calloc.free(snapshot);
+    }
+  }
+
+  /// Zeroes the native call statistics and restarts their window.
+  void resetNativeStats() => _statsReset();
+
+  /// State of the locked, dump-excluded pool the native library keeps
+  /// plaintext and key buffers in, or null if the library reports an
+  /// unknown layout.
+  SecureMemoryInfo? secureMemoryInfo() {
+    final report = calloc<_NativeSecmemReport>();
+    try {
+      _secmemReport(report);
+      if (report.ref.version != _secmemReportVersion) return null;
+      return SecureMemoryInfo._fromNative(report.ref);
+    } finally {
+      calloc.free(report);
+    }
+  }
 
-    final storedHash = checksumFile.readAsStringSync();
-    if (storedHash != currentHash) {
-      throw StateError(
-          'Native library checksum mismatch – expected $storedHash, got $currentHash. Possible tampering detected.');
+  /// Starts recording a span for every instrumented native call into a ring
+  /// of [capacity] events (0 = native default); the oldest are overwritten
+  /// once it is full. Returns the actual capacity, or -1 on failure.
+  int startNativeTrace({int capacity = 0}) => _traceStart(capacity);
+
+  /// Stops recording. Events already recorded stay available.
+  void stopNativeTrace() => _traceStop();
+
+  /// The recorded native spans as Chrome trace JSON, for Perfetto or
+  /// chrome://tracing. Timestamps use the same monotonic clock as the Dart
+  /// timeline on Linux and Android. With [clear] the next call only returns
+  /// newer events.
+  String? nativeTraceJson({bool clear = false}) {
+    final ptr = _traceDumpJson(clear ? 1 : 0);
+    if (ptr == nullptr) return null;
+    try {
+      return ptr.toDartString();
+    } finally {
+      _freeString(ptr);
     }
   }
 
+  static Future<String> _fileChecksumInBackground(String path) =>
+      Isolate.run(
+          () => sha256.convert(File(path).readAsBytesSync()).toString());
+
   /// Calls the native function and converts the result to a Dart String.
   String getLibsodiumVersion() {
     final versionPointer = _getLibsodiumVersionString();
@@ -211,202 +810,921 @@ class CryptoFFI {
   }
 
   /// Hashes a password using the native libsodium implementation.
-  String hashPassword(String password) {
-    // Convert the Dart String to a C-compatible Utf8 pointer.
-    final passwordPointer = password.toNativeUtf8();
-
-    // Call the native function.
-    final hashPointer = _hashPassword(passwordPointer);
-
-    // Convert the resulting C string back to a Dart String.
-    final hash = hashPointer.toDartString();
-
-    // IMPORTANT: Free the memory that was allocated by the C functions.
-    // We must free both the password pointer and the hash pointer.
-    _freeString(hashPointer);
-
-    // 🔐 Wipe password buffer before releasing it to the allocator to reduce
-    // the lifetime of secret material in memory.
-    final pwdLen = utf8.encode(password).length + 1; // +1 for null-terminator
-    final pwdView = passwordPointer.cast<Uint8>().asTypedList(pwdLen);
-    for (int i = 0; i < pwdView.length; i++) {
-      pwdView[i] = 0;
-    }
-    calloc.free(passwordPointer);
+  String hashPassword(String password) => _withScratch(() {
+        // Scratch memory is wiped on release, password included.
+        final passwordPointer = password.toNativeUtf8(allocator: _scratch);
+        final hashPointer = _hashPassword(passwordPointer);
+        final hash = hashPointer.toDartString();
+        _freeString(hashPointer);
+        return hash;
+      });
 
-    return hash;
+  /// Verifies a password against a native hash.
+  bool verifyPassword(String hash, String password) => _withScratch(() {
+        final hashPointer = hash.toNativeUtf8(allocator: _scratch);
+        final passwordPointer = password.toNativeUtf8(allocator: _scratch);
+        return _verifyPassword(hashPointer, passwordPointer);
+      });
+
+  /// Encrypts arbitrary bytes with a given key using libsodium (native).
+  /// Returns the encrypted bytes (nonce + ciphertext + MAC) as raw bytes.
+  /// When [associatedData] is given it is authenticated but not encrypted,
+  /// and must be passed again to [decryptBytes].
+  Uint8List encryptBytes(Uint8List data, Uint8List key,
+          {Uint8List? associatedData}) =>
+      _withScratch(() {
+        final dataPtr = _copyToScratch(data);
+        final keyPtr = _copyToScratch(key);
+
+        final Pointer<Utf8> encPtr;
+        if (associatedData == null) {
+          encPtr = _encryptBytes(dataPtr, data.length, keyPtr, key.length);
+        } else {
+          encPtr = _encryptBytesAd(dataPtr, data.length, keyPtr, key.length,
+              _copyToScratch(associatedData), associatedData.length);
+        }
+
+        if (encPtr.address == 0) {
+          throw StateError('Native encryption failed');
+        }
+        return _takeBase64(encPtr);
+      });
+
+  /// Decrypts bytes that were encrypted with [encryptBytes]. Any
+  /// [associatedData] used at encryption time must be supplied unchanged.
+  Uint8List decryptBytes(Uint8List encryptedBytes, Uint8List key,
+          {Uint8List? associatedData}) =>
+      _withScratch(() {
+        final cipherPtr = _toNativeBase64(encryptedBytes);
+        final keyPtr = _copyToScratch(key);
+
+        final Pointer<Utf8> plainPtr;
+        if (associatedData == null) {
+          plainPtr = _decryptBytes(cipherPtr, keyPtr, key.length);
+        } else {
+          plainPtr = _decryptBytesAd(cipherPtr, keyPtr, key.length,
+              _copyToScratch(associatedData), associatedData.length);
+        }
+
+        if (plainPtr.address == 0) {
+          throw StateError('Native decryption failed');
+        }
+        return _takeBase64(plainPtr);
+      });
+
+  /// Returns [len] bytes from the native buffered CSPRNG.
+  Uint8List randomBytes(int len) {
+    final out = Uint8List(len);
+    fillRandom(out);
+    return out;
   }
 
-  /// Verifies a password against a native hash.
-  bool verifyPassword(String hash, String password) {
-    // Convert Dart Strings to C-compatible Utf8 pointers.
-    final hashPointer = hash.toNativeUtf8();
-    final passwordPointer = password.toNativeUtf8();
-
-    // Call the native function.
-    final isValid = _verifyPassword(hashPointer, passwordPointer);
-
-    // IMPORTANT: Free the allocated memory.
-    // Wipe both buffers before freeing.
-    final hashLen = utf8.encode(hash).length + 1;
-    final hashView = hashPointer.cast<Uint8>().asTypedList(hashLen);
-    for (int i = 0; i < hashView.length; i++) {
-      hashView[i] = 0;
+  /// Overwrites [out] with random bytes from the native buffered CSPRNG
+  /// (ChaCha20, reseeded from the OS). Large buffers are filled in 32 KiB
+  /// steps through the scratch arena, which is wiped afterwards.
+  void fillRandom(Uint8List out) {
+    if (out.isEmpty) return;
+    const step = 32 * 1024;
+    _withScratch(() {
+      final n = out.length < step ? out.length : step;
+      final buf = _scratch<Uint8>(n);
+      final view = buf.asTypedList(n);
+      for (var off = 0; off < out.length; off += n) {
+        final len = out.length - off < n ? out.length - off : n;
+        if (_rngFill(buf, len) != 0) throw StateError('rng_fill failed');
+        out.setRange(off, off + len, view);
+      }
+    });
+  }
+
+  Uint8List deriveSessionKey(Uint8List master, Uint8List eph, Uint8List salt) =>
+      _withScratch(() {
+        final ptr = _deriveSessionKeyB64(_copyToScratch(master), master.length,
+            _copyToScratch(eph), eph.length, _copyToScratch(salt), salt.length);
+        if (ptr.address == 0) {
+          throw StateError('derive_session_key_b64 failed');
+        }
+        return _takeBase64(ptr);
+      });
+
+  Uint8List pbkdf2Sha256(String password, Uint8List salt, int dkLen) =>
+      _withScratch(() {
+        final ptr = _pbkdf2B64(password.toNativeUtf8(allocator: _scratch),
+            _copyToScratch(salt), salt.length, dkLen);
+        if (ptr.address == 0) {
+          throw StateError('pbkdf2_sha256_b64 failed');
+        }
+        return _takeBase64(ptr);
+      });
+
+  /// Encodes [data] as padded standard Base64 in native code (AVX2/SSSE3 or
+  /// NEON where available). Drop-in for `base64.encode` on large payloads.
+  String base64Encode(Uint8List data) => _withScratch(() {
+        final outLen = _base64Length(data.length);
+        final outPtr = _scratch<Uint8>(outLen);
+        if (_base64Encode(_copyToScratch(data), data.length, outPtr, outLen) !=
+            outLen) {
+          throw StateError('base64_encode failed');
+        }
+        return String.fromCharCodes(outPtr.asTypedList(outLen));
+      });
+
+  /// Decodes standard or URL-safe Base64, padded or not. Throws a
+  /// [FormatException] on malformed input, like `base64.decode`.
+  Uint8List base64Decode(String text) => _decodeText(text, _base64Decode,
+      text.length ~/ 4 * 3 + text.length % 4 * 3 ~/ 4, 'Base64');
+
+  /// Encodes [data] as upper-case RFC 4648 Base32, unpadded unless
+  /// [padding] is set (authenticator URIs expect it without).
+  String base32Encode(Uint8List data, {bool padding = false}) =>
+      _withScratch(() {
+        final outLen = padding
+            ? (data.length + 4) ~/ 5 * 8
+            : (data.length * 8 + 4) ~/ 5;
+        final outPtr = _scratch<Uint8>(outLen);
+        final n = _base32Encode(_copyToScratch(data), data.length, outPtr,
+            outLen, padding ? 1 : 0);
+        if (n != outLen) {
+          throw StateError('base32_encode failed');
+        }
+        return String.fromCharCodes(outPtr.asTypedList(outLen));
+      });
+
+  /// Decodes Base32 case-insensitively, skipping '=', spaces and '-'.
+  Uint8List base32Decode(String text) =>
+      _decodeText(text, _base32Decode, text.length * 5 ~/ 8, 'Base32');
+
+  static int _base64Length(int binLen) => (binLen + 2) ~/ 3 * 4;
+
+  Uint8List _decodeText(
+          String text, _CodecDart decode, int maxLen, String codec) =>
+      _withScratch(() {
+        final inPtr = _scratch<Uint8>(text.length);
+        final outPtr = _scratch<Uint8>(maxLen);
+        final input = inPtr.asTypedList(text.length);
+        for (var i = 0; i < text.length; i++) {
+          final unit = text.codeUnitAt(i);
+          // Storing into Uint8 would truncate; reject before it can alias
+          // a valid character.
+          if (unit > 0x7f) {
+            throw FormatException('Invalid $codec character', text, i);
+          }
+          input[i] = unit;
+        }
+        final n = decode(inPtr, text.length, outPtr, maxLen);
+        if (n < 0) {
+          throw FormatException('Invalid $codec input', text);
+        }
+        return Uint8List.fromList(outPtr.asTypedList(n));
+      });
+
+  /// Decodes a Base64 string returned by the native library straight from
+  /// native memory, then frees it.
+  Uint8List _takeBase64(Pointer<Utf8> ptr) => _withScratch(() {
+        try {
+          final len = ptr.length;
+          final maxLen = len ~/ 4 * 3 + len % 4 * 3 ~/ 4;
+          final outPtr = _scratch<Uint8>(maxLen);
+          final n = _base64Decode(ptr.cast<Uint8>(), len, outPtr, maxLen);
+          if (n < 0) {
+            throw StateError('Native library returned malformed Base64');
+          }
+          return Uint8List.fromList(outPtr.asTypedList(n));
+        } finally {
+          _freeString(ptr);
+        }
+      });
+
+  /// Base64-encodes [data] into a NUL-terminated scratch string for the
+  /// `*_b64` native entry points (inside [_withScratch]).
+  Pointer<Utf8> _toNativeBase64(Uint8List data) {
+    final outLen = _base64Length(data.length);
+    final outPtr = _scratch<Uint8>(outLen + 1); // zeroed: terminator included
+    if (_base64Encode(_copyToScratch(data), data.length, outPtr, outLen) !=
+        outLen) {
+      throw StateError('base64_encode failed');
     }
+    return outPtr.cast<Utf8>();
+  }
 
-    final pwdLen = utf8.encode(password).length + 1;
-    final pwdView = passwordPointer.cast<Uint8>().asTypedList(pwdLen);
-    for (int i = 0; i < pwdView.length; i++) {
-      pwdView[i] = 0;
+  /// Runs [body] between a mark and release of this thread's native scratch
+  /// arena: everything it takes from [_scratch] is wiped and reclaimed when
+  /// it returns or throws. [body] must not await — the isolate could resume
+  /// on another thread. Temporaries that fit the arena's 64 KiB chunk use
+  /// locked pool memory; larger payloads get heap-backed chunks (see
+  /// native_scratch.h).
+  T _withScratch<T>(T Function() body) {
+    _requireIntactLibrary();
+    final mark = _scratchMark();
+    try {
+      return body();
+    } finally {
+      _scratchRelease(mark);
     }
+  }
 
-    calloc.free(hashPointer);
-    calloc.free(passwordPointer);
+  /// Copies [data] into scratch memory (inside [_withScratch]).
+  Pointer<Uint8> _copyToScratch(List<int> data) {
+    final ptr = _scratch<Uint8>(data.length);
+    ptr.asTypedList(data.length).setAll(0, data);
+    return ptr;
+  }
 
-    return isValid;
+  // Secure wipe flags and per-file results – must match WIPE_* in
+  // native_wipe.h.
+  static const int wipeFlagPatterns = 0x01;
+  static const int wipeFlagDirect = 0x02;
+  static const int wipeMaxPasses = 35;
+  static const int wipeResultDone = 0;
+  static const int wipeResultPartial = 1;
+  static const int wipeResultMissing = 2;
+  static const int wipeResultFailed = -1;
+
+  /// Overwrites every file in [paths] with [passes] synced passes, then
+  /// truncates and unlinks it, spreading files over [threads] native workers
+  /// (0 = automatic). Once [deadline] elapses remaining passes are skipped,
+  /// but each file still gets one full pass and is removed. Blocks until
+  /// done, so call it from a background isolate. Returns one
+  /// `wipeResult*` code per path.
+  List<int> secureWipeFiles(List<String> paths,
+      {int passes = 3, int flags = 0, int threads = 0, Duration? deadline}) {
+    if (paths.isEmpty) return const [];
+    _requireIntactLibrary();
+    final pathPtrs = calloc<Pointer<Utf8>>(paths.length);
+    final results = calloc<Int8>(paths.length);
+    try {
+      for (var i = 0; i < paths.length; i++) {
+        pathPtrs[i] = paths[i].toNativeUtf8(allocator: calloc);
+      }
+      final rc = _secureWipeFiles(pathPtrs, paths.length, passes, flags,
+          threads, deadline?.inMilliseconds ?? 0, results);
+      if (rc < 0) {
+        throw ArgumentError('Invalid wipe request ($passes passes)');
+      }
+      return List<int>.from(results.asTypedList(paths.length));
+    } finally {
+      for (var i = 0; i < paths.length; i++) {
+        if (pathPtrs[i].address != 0) calloc.free(pathPtrs[i]);
+      }
+      calloc.free(pathPtrs);
+      calloc.free(results);
+    }
   }
 
-  /// Encrypts arbitrary bytes with a given key using libsodium (native).
-  /// Returns the encrypted bytes (nonce + ciphertext + MAC) as raw bytes.
-  Uint8List encryptBytes(Uint8List data, Uint8List key) {
-    final dataPtr = calloc<Uint8>(data.length);
-    final keyPtr = calloc<Uint8>(key.length);
+  /// Securely wipes [data] in native space to reduce the residency time of
+  /// plaintext secrets. The Dart List memory is first copied into a malloc()'d
+  /// buffer so we can pass a raw pointer to libsodium's sodium_memzero(), then
+  /// the copy is destroyed. NOTE: This cannot wipe the original Dart object –
+  /// only reduce exposure of temporary native copies.
+  void secureMemzero(Uint8List data) {
+    _requireIntactLibrary();
+    final ptr = calloc<Uint8>(data.length);
+    ptr.asTypedList(data.length).setAll(0, data);
+    _secureMemzero(ptr, data.length);
+    calloc.free(ptr);
+  }
+
+  /// Hashes [data] natively with SHA-256 (default) or BLAKE2b. For BLAKE2b
+  /// [digestLength] may be 16..64 bytes; 0 selects the 32-byte default.
+  Uint8List hashBytes(Uint8List data,
+          {int alg = hashAlgSha256, int digestLength = 0}) =>
+      _withScratch(() {
+        final outLen = _digestLengthFor(alg, digestLength);
+        final outPtr = _scratch<Uint8>(outLen);
+        final n = _hashBytes(
+            alg, _copyToScratch(data), data.length, outPtr, outLen);
+        if (n != outLen) {
+          throw StateError('hash_bytes failed');
+        }
+        return Uint8List.fromList(outPtr.asTypedList(outLen));
+      });
+
+  /// Hashes the file at [path] in native code without reading it into the
+  /// Dart heap.
+  Uint8List hashFile(String path,
+          {int alg = hashAlgSha256, int digestLength = 0}) =>
+      _withScratch(() {
+        final outLen = _digestLengthFor(alg, digestLength);
+        final outPtr = _scratch<Uint8>(outLen);
+        final n = _hashFile(
+            alg, path.toNativeUtf8(allocator: _scratch), outPtr, outLen);
+        if (n != outLen) {
+          throw StateError('hash_file failed for $path');
+        }
+        return Uint8List.fromList(outPtr.asTypedList(outLen));
+      });
+
+  /// Starts an incremental native hash. The returned [NativeHasher] must be
+  /// finished with [NativeHasher.finish] (or [NativeHasher.dispose]) to
+  /// release its native state.
+  NativeHasher createHasher({int alg = hashAlgSha256, int digestLength = 0}) {
+    _requireIntactLibrary();
+    final outLen = _digestLengthFor(alg, digestLength);
+    final ctx = _hashCtxNew(alg, digestLength);
+    if (ctx.address == 0) {
+      throw StateError('hash_ctx_new failed');
+    }
+    return NativeHasher._(this, ctx, outLen);
+  }
 
-    dataPtr.asTypedList(data.length).setAll(0, data);
-    keyPtr.asTypedList(key.length).setAll(0, key);
+  // OTP HMAC identifiers – must match OTP_ALG_* in native_crypto.h.
+  static const int otpAlgSha1 = 1;
+  static const int otpAlgSha256 = 2;
+  static const int otpAlgSha512 = 3;
+
+  /// Decodes a Base32 TOTP secret into a native key handle. The raw secret
+  /// only ever exists in guarded native memory; call [OtpKey.dispose] when
+  /// done.
+  OtpKey createOtpKey(String secretBase32, {int alg = otpAlgSha1}) =>
+      _withScratch(() {
+        final key = _otpKeyNewBase32(
+            alg, secretBase32.toNativeUtf8(allocator: _scratch));
+        if (key.address == 0) {
+          throw ArgumentError('Invalid OTP secret or algorithm');
+        }
+        return OtpKey._(this, key);
+      });
+
+  /// Container magic written by the fused encrypt-and-hash functions
+  /// (`CONTAINER_MAGIC` in native_crypto.h).
+  static const List<int> containerMagic = [0x4E, 0x48, 0x43, 0x31]; // "NHC1"
+
+  /// `CONTAINER_FLAG_BOUND_AD` – container is bound to associated data.
+  static const int containerFlagBoundAd = 0x01;
+
+  /// AEAD ids recorded in the container header (`CONTAINER_AEAD_*`).
+  static const int containerAeadAuto = 0;
+  static const int containerAeadXChaCha20 = 1;
+  static const int containerAeadAes256Gcm = 2;
+
+  /// Forces the AEAD used for new containers. The default
+  /// ([containerAeadAuto]) seals with XChaCha20-Poly1305, which opens on
+  /// every device. [containerAeadAes256Gcm] is opt-in: it is faster where
+  /// the CPU has AES support, but its containers cannot be opened on a
+  /// device without it. Returns false if [aead] is unknown or unsupported
+  /// on this device.
+  bool setContainerAead(int aead) => _containerSetAead(aead) == 0;
+
+  /// AEAD id that new containers will be sealed with on this device.
+  int get selectedContainerAead => _containerSelectedAead();
+
+  /// Whether containers recorded with [aead] can be opened on this device.
+  bool containerAeadAvailable(int aead) => _containerAeadAvailable(aead) != 0;
+
+  /// Throws a descriptive error when the container starting with [header]
+  /// was sealed with an AEAD this device cannot run, so callers do not see
+  /// a bare decryption failure for a file that is not actually damaged.
+  void _checkContainerAead(Uint8List header) {
+    if (!isContainer(header) || containerAeadAvailable(header[5])) return;
+    throw UnsupportedError(
+        'Container was sealed with ${aeadName(header[5])}, which this '
+        'device cannot decrypt (no hardware AES support)');
+  }
 
-    final encPtr = _encryptBytes(dataPtr, data.length, keyPtr, key.length);
+  /// Human-readable name of the AEAD recorded in a container header, or
+  /// null if [data] is not a container.
+  static String? containerAlgorithmName(Uint8List data) {
+    if (!isContainer(data)) return null;
+    return aeadName(data[5]);
+  }
 
-    // Clean sensitive buffers before freeing.
-    for (var i = 0; i < key.length; i++) {
-      keyPtr[i] = 0;
+  static String aeadName(int aead) {
+    switch (aead) {
+      case containerAeadXChaCha20:
+        return 'XChaCha20-Poly1305';
+      case containerAeadAes256Gcm:
+        return 'AES-256-GCM';
+      default:
+        return 'unknown($aead)';
     }
-    calloc.free(dataPtr);
-    calloc.free(keyPtr);
+  }
 
-    if (encPtr.address == 0) {
-      throw StateError('Native encryption failed');
+  /// Returns true when [data] starts with a native container header.
+  static bool isContainer(Uint8List data) {
+    if (data.length < 40) return false;
+    for (var i = 0; i < containerMagic.length; i++) {
+      if (data[i] != containerMagic[i]) return false;
     }
+    return true;
+  }
 
-    final encBase64 = encPtr.toDartString();
-    _freeString(encPtr);
+  /// Returns true when [data] is a container sealed with associated data,
+  /// i.e. its integrity is fully covered by the AEAD tag.
+  static bool isBoundContainer(Uint8List data) =>
+      isContainer(data) && (data[6] & containerFlagBoundAd) != 0;
+
+  /// Encrypts [data] into a chunked container while hashing the plaintext in
+  /// the same native pass. No base64 round-trip is involved. Pass
+  /// `hashAlg: 0` to skip hashing. [associatedData] is authenticated (not
+  /// encrypted) and must be presented again to decrypt.
+  HashedCiphertext encryptAndHash(Uint8List data, Uint8List key,
+          {int hashAlg = hashAlgSha256, Uint8List? associatedData}) =>
+      _withScratch(() {
+        final digestLen = _digestLengthFor(hashAlg, 0);
+        final ad = associatedData ?? Uint8List(0);
+        final cap = _containerEncryptedSize(data.length);
+        final digestPtr = _scratch<Uint8>(digestLen);
+        final outPtr = _scratch<Uint8>(cap);
+        final outLenPtr = _scratch<IntPtr>();
+        final rc = _encryptBufferHashed(
+            _copyToScratch(data), data.length, _copyToScratch(key), key.length,
+            _copyToScratch(ad), ad.length, hashAlg, digestPtr, digestLen,
+            outPtr, cap, outLenPtr);
+        if (rc != 0) {
+          throw StateError('Native encrypt-and-hash failed');
+        }
+        return HashedCiphertext(
+          cipher: Uint8List.fromList(outPtr.asTypedList(outLenPtr.value)),
+          digest: Uint8List.fromList(digestPtr.asTypedList(digestLen)),
+        );
+      });
+
+  /// Decrypts a container produced by [encryptAndHash]; the returned digest
+  /// is computed over the recovered plaintext during the same pass (empty
+  /// when `hashAlg: 0`). [associatedData] must match the value used to seal.
+  HashedPlaintext decryptAndHash(Uint8List container, Uint8List key,
+          {int hashAlg = hashAlgSha256, Uint8List? associatedData}) =>
+      _withScratch(() {
+        final digestLen = _digestLengthFor(hashAlg, 0);
+        final ad = associatedData ?? Uint8List(0);
+        final digestPtr = _scratch<Uint8>(digestLen);
+        final outPtr = _scratch<Uint8>(container.length);
+        final outLenPtr = _scratch<IntPtr>();
+        final rc = _decryptBufferHashed(
+            _copyToScratch(container), container.length, _copyToScratch(key),
+            key.length, _copyToScratch(ad), ad.length, hashAlg, digestPtr,
+            digestLen, outPtr, container.length, outLenPtr);
+        if (rc != 0) {
+          _checkContainerAead(container);
+          throw StateError('Native decryption failed');
+        }
+        return HashedPlaintext(
+          data: Uint8List.fromList(outPtr.asTypedList(outLenPtr.value)),
+          digest: Uint8List.fromList(digestPtr.asTypedList(digestLen)),
+        );
+      });
+
+  /// Streams [inPath] into an encrypted container at [outPath], hashing the
+  /// plaintext on the way. Returns the plaintext digest.
+  Uint8List encryptFileHashed(String inPath, String outPath, Uint8List key,
+      {int hashAlg = hashAlgSha256, Uint8List? associatedData}) {
+    return _runFileHashed(_encryptFileHashed, 'encrypt', inPath, outPath, key,
+        hashAlg, associatedData);
+  }
 
-    return base64.decode(encBase64);
+  /// Streams the container at [inPath] back to plaintext at [outPath].
+  /// Returns the digest of the recovered plaintext.
+  Uint8List decryptFileHashed(String inPath, String outPath, Uint8List key,
+      {int hashAlg = hashAlgSha256, Uint8List? associatedData}) {
+    return _runFileHashed(_decryptFileHashed, 'decrypt', inPath, outPath, key,
+        hashAlg, associatedData);
   }
 
-  /// Decrypts bytes that were encrypted with [encryptBytes].
-  Uint8List decryptBytes(Uint8List encryptedBytes, Uint8List key) {
-    final cipherB64 = base64.encode(encryptedBytes);
+  Uint8List _runFileHashed(_FileHashedDart fn, String op, String inPath,
+          String outPath, Uint8List key, int hashAlg,
+          Uint8List? associatedData) =>
+      _withScratch(() {
+        final digestLen = _digestLengthFor(hashAlg, 0);
+        final ad = associatedData ?? Uint8List(0);
+        final digestPtr = _scratch<Uint8>(digestLen);
+        final rc = fn(
+            inPath.toNativeUtf8(allocator: _scratch),
+            outPath.toNativeUtf8(allocator: _scratch),
+            _copyToScratch(key),
+            key.length,
+            _copyToScratch(ad),
+            ad.length,
+            hashAlg,
+            digestPtr,
+            digestLen);
+        if (rc != 0) {
+          if (op == 'decrypt') _checkContainerAead(_readHeader(inPath));
+          throw StateError('Native file $op failed for $inPath');
+        }
+        return Uint8List.fromList(digestPtr.asTypedList(digestLen));
+      });
+
+  static Uint8List _readHeader(String path) {
+    try {
+      final file = File(path).openSync();
+      try {
+        return file.readSync(40);
+      } finally {
+        file.closeSync();
+      }
+    } on FileSystemException {
+      return Uint8List(0);
+    }
+  }
 
-    final cipherPtr = cipherB64.toNativeUtf8();
-    final keyPtr = calloc<Uint8>(key.length);
-    keyPtr.asTypedList(key.length).setAll(0, key);
+  static int _digestLengthFor(int alg, int digestLength) {
+    if (alg == 0) return 0; // hashing disabled
+    if (alg == hashAlgSha256) return 32;
+    if (alg == hashAlgBlake2b) return digestLength == 0 ? 32 : digestLength;
+    throw ArgumentError.value(alg, 'alg', 'Unknown hash algorithm');
+  }
+}
 
-    final plainPtr = _decryptBytes(cipherPtr, keyPtr, key.length);
+/// Result of [CryptoFFI.encryptAndHash].
+class HashedCiphertext {
+  final Uint8List cipher;
+  final Uint8List digest; // digest of the plaintext
 
-    // Wipe key buffer
-    for (var i = 0; i < key.length; i++) {
-      keyPtr[i] = 0;
-    }
-    calloc.free(keyPtr);
+  HashedCiphertext({required this.cipher, required this.digest});
+}
 
-    // wipe cipher buffer
-    final cipherView =
-        cipherPtr.cast<Uint8>().asTypedList(cipherB64.length + 1);
-    for (var i = 0; i < cipherView.length; i++) {
-      cipherView[i] = 0;
-    }
-    calloc.free(cipherPtr);
+/// Result of [CryptoFFI.decryptAndHash].
+class HashedPlaintext {
+  final Uint8List data;
+  final Uint8List digest;
 
-    if (plainPtr.address == 0) {
-      throw StateError('Native decryption failed');
-    }
+  HashedPlaintext({required this.data, required this.digest});
+}
 
-    final plainBase64 = plainPtr.toDartString();
-    _freeString(plainPtr);
+/// [Allocator] over the native per-thread scratch arena (native_scratch.h).
+/// Blocks come back zeroed and [free] is a no-op: they are wiped and
+/// reclaimed together when the enclosing [CryptoFFI._withScratch] returns.
+class _ScratchAllocator implements Allocator {
+  _ScratchAllocator(this._alloc);
 
-    return base64.decode(plainBase64);
-  }
+  final _ScratchAllocDart _alloc;
 
-  Uint8List randomBytes(int len) {
-    final ptr = _randomBytesB64(len);
+  @override
+  Pointer<T> allocate<T extends NativeType>(int byteCount, {int? alignment}) {
+    final ptr = _alloc(byteCount);
     if (ptr.address == 0) {
-      throw StateError('random_bytes_b64 failed');
+      throw ArgumentError('Could not allocate $byteCount scratch bytes.');
     }
-    final b64 = ptr.toDartString();
-    _freeString(ptr);
-    return base64.decode(b64);
+    return ptr.cast<T>();
   }
 
-  Uint8List deriveSessionKey(Uint8List master, Uint8List eph, Uint8List salt) {
-    final masterPtr = calloc<Uint8>(master.length);
-    final ephPtr = calloc<Uint8>(eph.length);
-    final saltPtr = calloc<Uint8>(salt.length);
+  @override
+  void free(Pointer<NativeType> pointer) {}
+}
 
-    masterPtr.asTypedList(master.length).setAll(0, master);
-    ephPtr.asTypedList(eph.length).setAll(0, eph);
-    saltPtr.asTypedList(salt.length).setAll(0, salt);
+/// Incremental native hash state (see `hash_ctx_*` in native_crypto.h).
+class NativeHasher {
+  NativeHasher._(this._ffi, this._ctx, this.digestLength);
 
-    final ptr = _deriveSessionKeyB64(
-        masterPtr, master.length, ephPtr, eph.length, saltPtr, salt.length);
+  final CryptoFFI _ffi;
+  Pointer<Void> _ctx;
+  final int digestLength;
 
-    // Wipe and free input buffers
-    for (int i = 0; i < master.length; i++) {
-      masterPtr[i] = 0;
+  /// Feeds [chunk] into the hash.
+  void add(List<int> chunk) {
+    if (_ctx.address == 0) {
+      throw StateError('NativeHasher already finished');
     }
-    for (int i = 0; i < eph.length; i++) {
-      ephPtr[i] = 0;
+    if (chunk.isEmpty) return;
+    _ffi._withScratch(() {
+      if (_ffi._hashCtxUpdate(_ctx, _ffi._copyToScratch(chunk), chunk.length) !=
+          0) {
+        throw StateError('hash_ctx_update failed');
+      }
+    });
+  }
+
+  /// Returns the digest and releases the native state.
+  Uint8List finish() {
+    if (_ctx.address == 0) {
+      throw StateError('NativeHasher already finished');
     }
-    for (int i = 0; i < salt.length; i++) {
-      saltPtr[i] = 0;
+    try {
+      return _ffi._withScratch(() {
+        final outPtr = _ffi._scratch<Uint8>(digestLength);
+        if (_ffi._hashCtxFinal(_ctx, outPtr, digestLength) != digestLength) {
+          throw StateError('hash_ctx_final failed');
+        }
+        return Uint8List.fromList(outPtr.asTypedList(digestLength));
+      });
+    } finally {
+      dispose();
     }
-    calloc.free(masterPtr);
-    calloc.free(ephPtr);
-    calloc.free(saltPtr);
+  }
 
-    if (ptr.address == 0) {
-      throw StateError('derive_session_key_b64 failed');
-    }
-    final b64 = ptr.toDartString();
-    _freeString(ptr);
-    return base64.decode(b64);
+  /// Releases the native state without producing a digest.
+  void dispose() {
+    if (_ctx.address == 0) return;
+    _ffi._hashCtxFree(_ctx);
+    _ctx = nullptr;
   }
+}
 
-  Uint8List pbkdf2Sha256(String password, Uint8List salt, int dkLen) {
-    final pwdPtr = password.toNativeUtf8();
-    final saltPtr = calloc<Uint8>(salt.length);
-    saltPtr.asTypedList(salt.length).setAll(0, salt);
+/// Native HOTP/TOTP key created by [CryptoFFI.createOtpKey].
+class OtpKey {
+  OtpKey._(this._ffi, this._key);
 
-    final ptr = _pbkdf2B64(pwdPtr, saltPtr, salt.length, dkLen);
+  final CryptoFFI _ffi;
+  Pointer<Void> _key;
 
-    // wipe
-    final pwdBytes = pwdPtr.cast<Uint8>().asTypedList(password.length + 1);
-    for (int i = 0; i < pwdBytes.length; i++) {
-      pwdBytes[i] = 0;
-    }
-    calloc.free(pwdPtr);
-    for (int i = 0; i < salt.length; i++) {
-      saltPtr[i] = 0;
+  // Reused out-parameter so verification allocates nothing per call.
+  late final Pointer<Int32> _matchedOffset = calloc<Int32>();
+
+  Pointer<Void> get _handle {
+    if (_key.address == 0) throw StateError('OtpKey already disposed');
+    return _key;
+  }
+
+  /// TOTP code for [unixTime] as an integer (pad to [digits] for display).
+  int totp(int unixTime, {int step = 30, int digits = 6}) {
+    final code = _ffi._totpGenerate(_handle, unixTime, step, digits);
+    if (code < 0) throw ArgumentError('Invalid TOTP parameters');
+    return code;
+  }
+
+  /// Checks [code] against all steps within ±[window] of [unixTime] in one
+  /// constant-time native call. Returns the matching step offset, or null.
+  int? verifyTotp(int code, int unixTime,
+      {int step = 30, int digits = 6, int window = 1}) {
+    final rc = _ffi._totpVerify(
+        _handle, unixTime, step, digits, code, window, _matchedOffset);
+    if (rc < 0) throw ArgumentError('Invalid TOTP parameters');
+    return rc == 1 ? _matchedOffset.value : null;
+  }
+
+  /// Wipes and frees the native key.
+  void dispose() {
+    if (_key.address == 0) return;
+    _ffi._otpKeyFree(_key);
+    _key = nullptr;
+    calloc.free(_matchedOffset);
+  }
+}
+
+/// Outcome of [CryptoFFI.libraryIntegrity].
+class LibrarySelfCheck {
+  const LibrarySelfCheck(
+      this.digest, this.memoryDigest, this.elapsed, this.matchesPinned);
+
+  /// SHA-256 hex of the library file, computed in Dart; this is what is
+  /// compared with the pin. Null on mobile or if the file could not be read.
+  final String? digest;
+
+  /// `blake2b-mem:<hex>` of the mapped read-only segments, as reported by
+  /// the library itself. Diagnostic only: a patched library could lie.
+  final String? memoryDigest;
+
+  /// Wall time from library load until the check completed.
+  final Duration elapsed;
+
+  /// Whether [digest] equals the pinned value; null on first run and on
+  /// mobile, false when the file could not be hashed.
+  final bool? matchesPinned;
+
+  bool get tampered => matchesPinned == false;
+}
+
+// Mirrors crypto_warmup_report in native_crypto.h.
+const int _warmupReportVersion = 1;
+
+final class _NativeWarmupReport extends Struct {
+  @Uint32()
+  external int version;
+  @Int32()
+  external int status;
+  @Uint64()
+  external int opslimit;
+  @Uint64()
+  external int memlimit;
+  @Uint64()
+  external int sodiumInitNs;
+  @Uint64()
+  external int kdfSelectNs;
+  @Uint64()
+  external int kdfArenaNs;
+  @Uint64()
+  external int cpuProbeNs;
+  @Uint64()
+  external int totalNs;
+}
+
+/// Outcome of [CryptoFFI.warmup].
+class CryptoWarmup {
+  CryptoWarmup._fromNative(_NativeWarmupReport r)
+      : ok = r.status == 0,
+        opslimit = r.opslimit,
+        memlimit = r.memlimit,
+        sodiumInit = Duration(microseconds: r.sodiumInitNs ~/ 1000),
+        kdfSelect = Duration(microseconds: r.kdfSelectNs ~/ 1000),
+        kdfArena = Duration(microseconds: r.kdfArenaNs ~/ 1000),
+        cpuProbe = Duration(microseconds: r.cpuProbeNs ~/ 1000),
+        total = Duration(microseconds: r.totalNs ~/ 1000);
+
+  /// False if libsodium failed to initialise.
+  final bool ok;
+
+  /// Argon2id parameters selected for this device.
+  final int opslimit;
+  final int memlimit;
+
+  final Duration sodiumInit;
+  final Duration kdfSelect;
+
+  /// Throwaway Argon2 pass at the real memlimit; zero unless requested
+  /// with WARMUP_FLAG_KDF_ARENA (the app does not).
+  final Duration kdfArena;
+  final Duration cpuProbe;
+  final Duration total;
+
+  Map<String, dynamic> toJson() => {
+        'ok': ok,
+        'opslimit': opslimit,
+        'memlimitMiB': memlimit >> 20,
+        'sodiumInitUs': sodiumInit.inMicroseconds,
+        'kdfSelectUs': kdfSelect.inMicroseconds,
+        'kdfArenaMs': kdfArena.inMilliseconds,
+        'cpuProbeUs': cpuProbe.inMicroseconds,
+        'totalMs': total.inMilliseconds,
+      };
+}
+
+// Mirrors native_crypto_stats_snapshot / native_stats_fn in native_stats.h.
+const int _statsSnapshotVersion = 2;
+const int _statsFnCount = 24;
+const int _statsHistBuckets = 40;
+
+final class _NativeStatsFn extends Struct {
+  @Uint64()
+  external int calls;
+  @Uint64()
+  external int bytes;
+  @Uint64()
+  external int totalNs;
+  @Uint64()
+  external int maxNs;
+  @Array(_statsHistBuckets)
+  external Array<Uint64> latencyHist;
+  @Array(_statsHistBuckets)
+  external Array<Uint64> sizeHist;
+}
+
+final class _NativeStatsSnapshot extends Struct {
+  @Uint32()
+  external int version;
+  @Uint32()
+  external int fnCount;
+  @Uint32()
+  external int enabled;
+  @Uint32()
+  external int reserved;
+  @Uint64()
+  external int windowNs;
+  @Array(_statsFnCount)
+  external Array<_NativeStatsFn> fns;
+}
+
+/// Counters for one native entry point. Histogram bucket `i` counts values
+/// `v` with `floor(log2(v)) == i` (latencies in ns, sizes in bytes).
+class NativeCallStats {
+  NativeCallStats._fromNative(this.name, _NativeStatsFn fn)
+      : calls = fn.calls,
+        bytes = fn.bytes,
+        total = Duration(microseconds: fn.totalNs ~/ 1000),
+        max = Duration(microseconds: fn.maxNs ~/ 1000),
+        latencyHistogram = List.unmodifiable(
+            [for (var i = 0; i < _statsHistBuckets; i++) fn.latencyHist[i]]),
+        sizeHistogram = List.unmodifiable(
+            [for (var i = 0; i < _statsHistBuckets; i++) fn.sizeHist[i]]);
+
+  final String name;
+  final int calls;
+  final int bytes;
+  final Duration total;
+  final Duration max;
+  final List<int> latencyHistogram;
+  final List<int> sizeHistogram;
+
+  Duration get mean => calls == 0
+      ? Duration.zero
+      : Duration(microseconds: total.inMicroseconds ~/ calls);
+
+  /// Upper bound of the latency bucket holding the [q] quantile (0..1).
+  Duration latencyQuantile(double q) {
+    final target = (calls * q).ceil().clamp(1, calls);
+    var seen = 0;
+    for (var i = 0; i < latencyHistogram.length; i++) {
+      seen += latencyHistogram[i];
+      if (seen >= target) {
+        return Duration(microseconds: (1 << (i + 1)) ~/ 1000);
+      }
     }
-    calloc.free(saltPtr);
+    return max;
+  }
 
-    if (ptr.address == 0) {
-      throw StateError('pbkdf2_sha256_b64 failed');
+  Map<String, dynamic> toJson() => {
+        'calls': calls,
+        'bytes': bytes,
+        'totalMs': total.inMilliseconds,
+        'meanUs': mean.inMicroseconds,
+        'p50UsMax': latencyQuantile(0.5).inMicroseconds,
+        'p99UsMax': latencyQuantile(0.99).inMicroseconds,
+        'maxUs': max.inMicroseconds,
+        'latencyLog2Ns': _trimmed(latencyHistogram),
+        'sizeLog2Bytes': _trimmed(sizeHistogram),
+      };
+
+  // Drops trailing empty buckets to keep diagnostics readable.
+  static List<int> _trimmed(List<int> histogram) {
+    var end = histogram.length;
+    while (end > 0 && histogram[end - 1] == 0) {
+      end--;
     }
-    final b64 = ptr.toDartString();
-    _freeString(ptr);
-    return base64.decode(b64);
+    return histogram.sublist(0, end);
   }
+}
 
-  /// Securely wipes [data] in native space to reduce the residency time of
-  /// plaintext secrets. The Dart List memory is first copied into a malloc()'d
-  /// buffer so we can pass a raw pointer to libsodium's sodium_memzero(), then
-  /// the copy is destroyed. NOTE: This cannot wipe the original Dart object –
-  /// only reduce exposure of temporary native copies.
-  void secureMemzero(Uint8List data) {
-    final ptr = calloc<Uint8>(data.length);
-    ptr.asTypedList(data.length).setAll(0, data);
-    _secureMemzero(ptr, data.length);
-    calloc.free(ptr);
+/// Snapshot returned by [CryptoFFI.nativeStats].
+class NativeCryptoStats {
+  const NativeCryptoStats(this.enabled, this.window, this.functions);
+
+  /// False when the library was built with NATIVE_CRYPTO_STATS=OFF.
+  final bool enabled;
+
+  /// Time since the first recorded call or the last reset.
+  final Duration window;
+  final List<NativeCallStats> functions;
+
+  NativeCallStats? operator [](String name) {
+    for (final fn in functions) {
+      if (fn.name == name) return fn;
+    }
+    return null;
   }
+
+  Map<String, dynamic> toJson() => {
+        'enabled': enabled,
+        'windowMs': window.inMilliseconds,
+        'functions': {for (final fn in functions) fn.name: fn.toJson()},
+      };
+}
+
+// Mirrors secmem_report in native_secmem.h.
+const int _secmemReportVersion = 1;
+
+final class _NativeSecmemReport extends Struct {
+  @Uint32()
+  external int version;
+  @Uint32()
+  external int flags;
+  @Uint64()
+  external int regionBytes;
+  @Uint64()
+  external int lockedBytes;
+  @Uint64()
+  external int slabsUsed;
+  @Uint64()
+  external int inUseBytes;
+  @Uint64()
+  external int peakBytes;
+  @Uint64()
+  external int poolAllocs;
+  @Uint64()
+  external int fallbackAllocs;
+}
+
+/// Snapshot returned by [CryptoFFI.secureMemoryInfo].
+class SecureMemoryInfo {
+  SecureMemoryInfo._fromNative(_NativeSecmemReport r)
+      : mapped = r.flags & 0x01 != 0,
+        locked = r.flags & 0x02 != 0,
+        excludedFromDumps = r.flags & 0x04 != 0,
+        guarded = r.flags & 0x08 != 0,
+        regionBytes = r.regionBytes,
+        lockedBytes = r.lockedBytes,
+        inUseBytes = r.inUseBytes,
+        peakBytes = r.peakBytes,
+        poolAllocs = r.poolAllocs,
+        fallbackAllocs = r.fallbackAllocs;
+
+  /// False if the pool could not be mapped and every buffer came from
+  /// malloc().
+  final bool mapped;
+
+  /// True when the whole pool is locked; [lockedBytes] is the locked
+  /// prefix when RLIMIT_MEMLOCK is smaller.
+  final bool locked;
+  final bool excludedFromDumps;
+  final bool guarded;
+  final int regionBytes;
+  final int lockedBytes;
+  final int inUseBytes;
+  final int peakBytes;
+  final int poolAllocs;
+
+  /// Allocations too large for the pool (or made while it was full);
+  /// still wiped on free, but not locked.
+  final int fallbackAllocs;
+
+  Map<String, dynamic> toJson() => {
+        'mapped': mapped,
+        'locked': locked,
+        'excludedFromDumps': excludedFromDumps,
+        'guarded': guarded,
+        'regionKiB': regionBytes >> 10,
+        'lockedKiB': lockedBytes >> 10,
+        'inUseBytes': inUseBytes,
+        'peakBytes': peakBytes,
+        'poolAllocs': poolAllocs,
+        'fallbackAllocs': fallbackAllocs,
+      };
 }
@@ -1,11 +1,9 @@
 import 'dart:math';
 import 'dart:typed_data';
 import 'dart:convert';
-import 'package:crypto/crypto.dart';
 import 'package:notehider/models/file_models.dart';
 import 'package:pointycastle/api.dart';
 import 'package:pointycastle/random/fortuna_random.dart';
-import 'package:pointycastle/digests/sha256.dart';
 import 'crypto_ffi.dart';
 
 /// 🔒 CryptoService – thin Dart façade around the project's native
@@ -29,6 +27,9 @@ class CryptoService {
 
   static const int _ephemeralKeyLength = 32; // For Perfect Forward Secrecy
 
+  // Version of the clear-text record header bound as AAD in encryptFile().
+  static const int _recordHeaderVersion = 1;
+
   final FortunaRandom _secureRandom = FortunaRandom();
   final List<Uint8List> _memoryToSecureClear = [];
 
@@ -65,6 +66,7 @@ class CryptoService {
   /// • Key stretching with multiple rounds
   /// • Memory-hard operations
   Future<MilitaryHashResult> hashPasswordMilitary(String password) async {
+    await _cryptoFFI.ensureLibraryIntact();
     final nativeHashString = _cryptoFFI.hashPassword(password);
 
     // We will adapt the MilitaryHashResult to work with the native format.
@@ -90,6 +92,7 @@ class CryptoService {
   ) async {
     // The native verify function handles everything.
     // The `stored.hash` field now contains the full hash string from libsodium.
+    await _cryptoFFI.ensureLibraryIntact();
     return _cryptoFFI.verifyPassword(stored.hash, password);
   }
 
@@ -223,14 +226,20 @@ class CryptoService {
   }
 
   Future<Uint8List> deriveMasterKey(String password, Uint8List salt) async {
+    await _cryptoFFI.ensureLibraryIntact();
     return _cryptoFFI.pbkdf2Sha256(password, salt, _keyLength);
   }
 
   /// 📦 Simple wrapper around native libsodium symmetric encryption.
   /// Returns raw encrypted bytes (nonce + ciphertext + MAC) with no
   /// separate IV / tag fields required.
-  Future<EncryptedData> encryptData(Uint8List data, Uint8List masterKey) async {
-    final encryptedBytes = _cryptoFFI.encryptBytes(data, masterKey);
+  ///
+  /// [associatedData] is authenticated alongside the ciphertext without being
+  /// encrypted (record id, version, type …) and is required again to decrypt.
+  Future<EncryptedData> encryptData(Uint8List data, Uint8List masterKey,
+      {Uint8List? associatedData}) async {
+    final encryptedBytes = _cryptoFFI.encryptBytes(data, masterKey,
+        associatedData: associatedData);
     return EncryptedData(
       encryptedBytes: encryptedBytes,
       iv: Uint8List(0), // Not needed – nonce is embedded in ciphertext
@@ -239,8 +248,10 @@ class CryptoService {
   }
 
   Future<Uint8List> decryptData(
-      EncryptedData encryptedData, Uint8List masterKey) async {
-    return _cryptoFFI.decryptBytes(encryptedData.encryptedBytes, masterKey);
+      EncryptedData encryptedData, Uint8List masterKey,
+      {Uint8List? associatedData}) async {
+    return _cryptoFFI.decryptBytes(encryptedData.encryptedBytes, masterKey,
+        associatedData: associatedData);
   }
 
   // Updated file encryption methods with new FileMetadata structure
@@ -251,7 +262,16 @@ class CryptoService {
   }) async {
     final now = DateTime.now();
     final fileId = _generateUniqueId();
-    final fileHash = sha256.convert(fileData).toString();
+
+    // Single native pass: every block is hashed and encrypted together, and
+    // the container is bound to the file's identity so decryption can rely
+    // on the AEAD tag instead of re-hashing the plaintext.
+    final sealed = _cryptoFFI.encryptAndHash(
+      fileData,
+      masterKey,
+      associatedData: _fileBindingData(fileId, fileData.length),
+    );
+    final fileHash = _toHex(sealed.digest);
 
     // Create new FileMetadata with all required fields
     final metadata = FileMetadata(
@@ -271,16 +291,34 @@ class CryptoService {
     final metadataJson = jsonEncode(metadata.toJson());
     final metadataBytes = utf8.encode(metadataJson);
 
-    final encryptedData = await encryptData(fileData, masterKey);
+    // Public, indexable record header. It is stored in clear next to the
+    // ciphertexts and authenticated as AAD, so it can be listed/filtered
+    // without decrypting anything but cannot be altered undetected.
+    final recordHeader = jsonEncode({
+      'v': _recordHeaderVersion,
+      'id': fileId,
+      'type': metadata.type.name,
+    });
+
+    final encryptedData = EncryptedData(
+      encryptedBytes: sealed.cipher,
+      iv: Uint8List(0), // Nonce lives in the container header
+      authTag: Uint8List(0),
+    );
+    // Metadata (original name, MIME type …) stays confidential but is bound
+    // to the record header instead of being an unrelated second blob.
     final encryptedMetadata = await encryptData(
       Uint8List.fromList(metadataBytes),
       masterKey,
+      associatedData: Uint8List.fromList(utf8.encode(recordHeader)),
     );
 
     return EncryptedFile(
       encryptedData: encryptedData,
       encryptedMetadata: encryptedMetadata,
       id: fileId,
+      recordHeader: recordHeader,
+      dataHash: fileHash,
     );
   }
 
@@ -288,21 +326,54 @@ class CryptoService {
     EncryptedFile encryptedFile,
     Uint8List masterKey,
   ) async {
+    final recordHeader = encryptedFile.recordHeader;
     final decryptedMetadataBytes = await decryptData(
       encryptedFile.encryptedMetadata,
       masterKey,
+      associatedData: recordHeader == null
+          ? null
+          : Uint8List.fromList(utf8.encode(recordHeader)),
     );
 
     final metadataJson = utf8.decode(decryptedMetadataBytes);
     final metadata = FileMetadata.fromJson(jsonDecode(metadataJson));
+    if (recordHeader != null && encryptedFile.header?['id'] != metadata.id) {
+      throw Exception('File record header mismatch');
+    }
 
-    final decryptedData = await decryptData(
-      encryptedFile.encryptedData,
-      masterKey,
-    );
+    final encryptedBytes = encryptedFile.encryptedData.encryptedBytes;
+    if (CryptoFFI.isBoundContainer(encryptedBytes)) {
+      // Bound container: the AEAD recorded in its header already
+      // authenticates every byte, and the associated data ties the
+      // ciphertext to this file id and size, so no plaintext hash is needed.
+      final opened = _cryptoFFI.decryptAndHash(
+        encryptedBytes,
+        masterKey,
+        hashAlg: 0,
+        associatedData: _fileBindingData(metadata.id, metadata.sizeBytes),
+      );
+      return DecryptedFile(
+        fileName: metadata.originalName,
+        data: opened.data,
+        metadata: metadata,
+        authenticated: true,
+      );
+    }
+
+    // Legacy path – unbound container or pre-container blob: verify the
+    // plaintext against the stored SHA-256.
+    final Uint8List decryptedData;
+    final String currentChecksum;
+    if (CryptoFFI.isContainer(encryptedBytes)) {
+      final opened = _cryptoFFI.decryptAndHash(encryptedBytes, masterKey);
+      decryptedData = opened.data;
+      currentChecksum = _toHex(opened.digest);
+    } else {
+      decryptedData = await decryptData(encryptedFile.encryptedData, masterKey);
+      currentChecksum = _toHex(_cryptoFFI.hashBytes(decryptedData));
+    }
 
     // Verify file integrity
-    final currentChecksum = sha256.convert(decryptedData).toString();
     if (currentChecksum != metadata.fileHash) {
       throw Exception('File integrity check failed');
     }
@@ -314,6 +385,13 @@ class CryptoService {
     );
   }
 
+  /// Associated data binding a file container to its identity. Changing
+  /// this layout breaks decryption of existing bound containers.
+  Uint8List _fileBindingData(String fileId, int sizeBytes) {
+    return Uint8List.fromList(
+        utf8.encode('notehider.file.v1|$fileId|$sizeBytes'));
+  }
+
   /// 📁 FILE TYPE DETECTION
   FileType _getFileTypeFromName(String fileName) {
     final extension = fileName.split('.').last.toLowerCase();
@@ -422,10 +500,21 @@ class CryptoService {
   }
 
   /// 🧮 HASH DATA FOR INTEGRITY
+  ///
+  /// SHA-256 computed natively via libsodium; returns lowercase hex.
   Future<String> hashData(Uint8List data) async {
-    final digest = SHA256Digest();
-    final hash = digest.process(data);
-    return hash.map((b) => b.toRadixString(16).padLeft(2, '0')).join();
+    return _toHex(_cryptoFFI.hashBytes(data));
+  }
+
+  /// 🧮 HASH FILE ON DISK FOR INTEGRITY
+  ///
+  /// Streams the file through native SHA-256 without loading it into Dart.
+  Future<String> hashFile(String path) async {
+    return _toHex(_cryptoFFI.hashFile(path));
+  }
+
+  String _toHex(Uint8List bytes) {
+    return bytes.map((b) => b.toRadixString(16).padLeft(2, '0')).join();
   }
 }
 
@@ -532,38 +621,59 @@ class EncryptedFile {
   final EncryptedData encryptedMetadata;
   final String id;
 
+  /// Clear-text JSON record header (version, id, type) authenticated as AAD
+  /// of [encryptedMetadata]. Kept as the exact serialised string because the
+  /// AAD must match byte for byte. Null for records written before AAD
+  /// support.
+  final String? recordHeader;
+
+  /// SHA-256 (hex) of the plaintext, computed during encryption. Not
+  /// serialised – it is already stored inside [encryptedMetadata].
+  final String? dataHash;
+
   EncryptedFile({
     required this.encryptedData,
     required this.encryptedMetadata,
     required this.id,
+    this.recordHeader,
+    this.dataHash,
   });
 
+  /// Decoded [recordHeader] for indexing without decryption.
+  Map<String, dynamic>? get header => recordHeader == null
+      ? null
+      : jsonDecode(recordHeader!) as Map<String, dynamic>;
+
   Map<String, dynamic> toJson() => {
         'encryptedData': {
-          'bytes': base64.encode(encryptedData.encryptedBytes),
+          'bytes': CryptoFFI().base64Encode(encryptedData.encryptedBytes),
           'iv': base64.encode(encryptedData.iv),
           'authTag': base64.encode(encryptedData.authTag),
         },
         'encryptedMetadata': {
-          'bytes': base64.encode(encryptedMetadata.encryptedBytes),
+          'bytes': CryptoFFI().base64Encode(encryptedMetadata.encryptedBytes),
           'iv': base64.encode(encryptedMetadata.iv),
           'authTag': base64.encode(encryptedMetadata.authTag),
         },
         'id': id,
+        if (recordHeader != null) 'header': recordHeader,
       };
 
   factory EncryptedFile.fromJson(Map<String, dynamic> json) => EncryptedFile(
         encryptedData: EncryptedData(
-          encryptedBytes: base64.decode(json['encryptedData']['bytes']),
+          encryptedBytes:
+              CryptoFFI().base64Decode(json['encryptedData']['bytes']),
           iv: base64.decode(json['encryptedData']['iv']),
           authTag: base64.decode(json['encryptedData']['authTag']),
         ),
         encryptedMetadata: EncryptedData(
-          encryptedBytes: base64.decode(json['encryptedMetadata']['bytes']),
+          encryptedBytes:
+              CryptoFFI().base64Decode(json['encryptedMetadata']['bytes']),
           iv: base64.decode(json['encryptedMetadata']['iv']),
           authTag: base64.decode(json['encryptedMetadata']['authTag']),
         ),
         id: json['id'],
+        recordHeader: json['header'],
       );
 }
 
@@ -572,9 +682,14 @@ class DecryptedFile {
   final Uint8List data;
   final FileMetadata metadata;
 
+  /// True when integrity was established by the AEAD tag of a bound
+  /// container rather than by re-hashing the plaintext.
+  final bool authenticated;
+
   DecryptedFile({
     required this.fileName,
     required this.data,
     required this.metadata,
+    this.authenticated = false,
   });
 }
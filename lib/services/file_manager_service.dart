@@ -1,7 +1,8 @@
 /// 📁 MILITARY-GRADE FILE MANAGER SERVICE
 ///
 /// Secure file management with:
-/// • Hardware-backed encryption (AES-256-GCM)
+/// • Native encryption (XChaCha20-Poly1305 by default, which opens on any
+///   device; hardware AES-256-GCM on request)
 /// • File type detection and categorization
 /// • Thumbnail generation for images/videos
 /// • Secure storage with tamper detection
@@ -21,6 +22,7 @@ import 'package:flutter_secure_storage/flutter_secure_storage.dart';
 
 import 'package:notehider/models/file_models.dart';
 import 'package:notehider/services/crypto_service.dart';
+import 'package:notehider/services/crypto_ffi.dart';
 import 'package:notehider/services/storage_service.dart';
 import 'package:notehider/services/tamper_detection_service.dart';
 
@@ -166,15 +168,14 @@ class FileManagerService {
       final fileType = _detectFileType(fileName);
       final mimeType = lookupMimeType(fileName) ?? 'application/octet-stream';
 
-      // Generate file hash for integrity
-      final fileHash = await _cryptoService.hashData(fileData);
-
-      // Encrypt file data
+      // Encrypt file data (the integrity hash is computed in the same pass)
       final encryptedFile = await _cryptoService.encryptFile(
         fileName: fileName,
         fileData: fileData,
         masterKey: await _getMasterKey(),
       );
+      final fileHash = encryptedFile.dataHash ??
+          await _cryptoService.hashData(fileData);
 
       // Create secure file path
       final encryptedPath = path.join(_secureDirectory!.path, '$fileId.enc');
@@ -230,6 +231,9 @@ class FileManagerService {
           'mime_type': mimeType,
           'security_level': securityLevel.name,
           'has_thumbnail': thumbnailPath != null,
+          'cipher': CryptoFFI.containerAlgorithmName(
+                  encryptedFile.encryptedData.encryptedBytes) ??
+              'XChaCha20-Poly1305',
         },
       );
     } catch (e) {
@@ -292,9 +296,11 @@ class FileManagerService {
         await _getMasterKey(),
       );
 
-      // Verify integrity
-      final currentHash = await _cryptoService.hashData(decryptedFile.data);
-      if (currentHash != metadata.fileHash) {
+      // Verify integrity (bound containers are already authenticated by
+      // the AEAD tag during decryption)
+      if (!decryptedFile.authenticated &&
+          await _cryptoService.hashData(decryptedFile.data) !=
+              metadata.fileHash) {
         return FileExportResult(
           success: false,
           message: 'File integrity check failed',
@@ -693,11 +699,15 @@ class FileManagerService {
     return facets;
   }
 
+  /// Directory holding the encrypted `.enc` files and their thumbnails.
+  static Future<Directory> secureDirectory() async {
+    final appDocDir = await getApplicationDocumentsDirectory();
+    return Directory(path.join(appDocDir.path, _secureDirectoryName));
+  }
+
   /// 🗂️ STORAGE METHODS
   Future<void> _initializeSecureDirectory() async {
-    final appDocDir = await getApplicationDocumentsDirectory();
-    _secureDirectory =
-        Directory(path.join(appDocDir.path, _secureDirectoryName));
+    _secureDirectory = await secureDirectory();
 
     if (!await _secureDirectory!.exists()) {
       await _secureDirectory!.create(recursive: true);
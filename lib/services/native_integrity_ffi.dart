@@ -1,16 +1,118 @@
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:typed_data';
 
+import 'package:ffi/ffi.dart';
 
 /// Loads the native_crypto_library and exposes the quick integrity probe.
 class NativeIntegrity {
   NativeIntegrity._();
+
+  // Probe bitmask (see native_integrity.h).
+  static const int debuggerAttached = 0x01;
+  static const int suBinaryFound = 0x02;
+  static const int fridaDetected = 0x04;
+  static const int playVerdictFail = 0x08;
+  static const int selinuxPermissive = 0x10;
+  static const int magiskDetected = 0x20;
+  static const int xposedDetected = 0x40;
+  static const int hookInMemory = 0x80;
+
+  // Per-path bits returned by [probePaths] (see native_integrity.h).
+  static const int pathPresent = 0x01;
+  static const int pathDirectory = 0x02;
+  static const int pathExecutable = 0x04;
+  static const int pathDenied = 0x80;
+
+  // Bits returned by [scanMemoryMaps].
+  static const int mapsFrida = 0x01;
+  static const int mapsSubstrate = 0x02;
+  static const int mapsXposed = 0x04;
+  static const int mapsHookLib = 0x08;
+  static const int mapsMagisk = 0x10;
+  static const int mapsAnonRwx = 0x20;
+
   static final NativeIntegrity instance = NativeIntegrity._();
 
   late final DynamicLibrary _lib = _loadLib();
   late final int Function() _probe = _lib
       .lookup<NativeFunction<Uint32 Function()>>("quick_probe_native")
       .asFunction();
+  late final int Function() _fullProbe = _lib
+      .lookup<NativeFunction<Uint32 Function()>>("full_probe_native")
+      .asFunction();
+  late final void Function(int, int) _setCacheTtl = _lib
+      .lookup<NativeFunction<Void Function(Uint32, Uint32)>>(
+          "integrity_set_cache_ttl")
+      .asFunction();
+  late final void Function() _invalidateCache = _lib
+      .lookup<NativeFunction<Void Function()>>("integrity_invalidate_cache")
+      .asFunction();
+  late final int Function(
+          Pointer<NativeFunction<Void Function(Uint32, Uint32)>>, int)
+      _monitorStart = _lib
+          .lookup<
+              NativeFunction<
+                  Int32 Function(
+                      Pointer<NativeFunction<Void Function(Uint32, Uint32)>>,
+                      Uint32)>>("integrity_monitor_start")
+          .asFunction();
+  late final void Function() _monitorStop = _lib
+      .lookup<NativeFunction<Void Function()>>("integrity_monitor_stop")
+      .asFunction();
+
+  late final int Function(Pointer<Pointer<Utf8>>, int, Pointer<Uint8>)
+      _probePaths = _lib
+          .lookup<
+              NativeFunction<
+                  Int32 Function(Pointer<Pointer<Utf8>>, Size,
+                      Pointer<Uint8>)>>("integrity_probe_paths")
+          .asFunction();
+
+  late final int Function(Pointer<Uint32>) _scanMaps = _lib
+      .lookup<NativeFunction<Int32 Function(Pointer<Uint32>)>>(
+          "integrity_scan_maps")
+      .asFunction();
+
+  late final int Function(Pointer<Utf8>, Pointer<Uint8>, int, int)
+      _textBaseline = _lib
+          .lookup<
+              NativeFunction<
+                  Int64 Function(Pointer<Utf8>, Pointer<Uint8>, Size,
+                      Int32)>>("integrity_text_baseline")
+          .asFunction();
+  late final int Function(Pointer<Utf8>, int) _textVerify = _lib
+      .lookup<NativeFunction<Int32 Function(Pointer<Utf8>, Uint32)>>(
+          "integrity_text_verify")
+      .asFunction();
+
+  static const int textDigestBytes = 32;
+
+  late final int Function(Pointer<NativeIntegrityReport>, int) _reportFill =
+      _lib
+          .lookup<
+              NativeFunction<
+                  Int32 Function(Pointer<NativeIntegrityReport>,
+                      Int32)>>("integrity_report_fill")
+          .asFunction();
+  late final Pointer<Utf8> Function(int, int) _checkPath = _lib
+      .lookup<NativeFunction<Pointer<Utf8> Function(Uint32, Int32)>>(
+          "integrity_check_path")
+      .asFunction();
+
+  late final int Function(Pointer<Uint8>, int, Pointer<Uint8>, int)
+      _deviceFingerprint = _lib
+          .lookup<
+              NativeFunction<
+                  Int32 Function(Pointer<Uint8>, Size, Pointer<Uint8>,
+                      Size)>>("device_fingerprint")
+          .asFunction();
+
+  // Reused for every [report] call; Dart reads it field by field in place.
+  late final Pointer<NativeIntegrityReport> _reportBuffer =
+      calloc<NativeIntegrityReport>();
+
+  NativeCallable<Void Function(Uint32, Uint32)>? _monitorCallable;
 
   DynamicLibrary _loadLib() {
     const libName = "native_crypto_library";
@@ -27,5 +129,278 @@ class NativeIntegrity {
   }
 
   /// Returns bitmask of integrity flags. 0 means clean.
+  ///
+  /// Served from the native probe cache: only checks whose TTL expired are
+  /// re-run, so calling this frequently is cheap.
   int probe() => _probe();
+
+  /// Runs the probe (cached unless [fresh]) and returns every check's
+  /// status, matched path, timing and cache age from a single native call.
+  IntegrityReport report({bool fresh = false}) {
+    final rows = _reportFill(_reportBuffer, fresh ? 1 : 0);
+    final native = _reportBuffer.ref;
+    if (rows < 0 || native.version != integrityReportVersion) {
+      throw StateError('Unsupported native integrity report');
+    }
+
+    final checks = <IntegrityCheckResult>[];
+    for (var i = 0; i < native.checkCount; i++) {
+      final row = native.checks[i];
+      final detected = row.status == integrityCheckDetected;
+      final pathPtr =
+          detected ? _checkPath(row.flag, row.matchedIndex) : nullptr;
+      checks.add(IntegrityCheckResult(
+        flag: row.flag,
+        detected: detected,
+        matchedIndex: row.matchedIndex,
+        matchedPath: pathPtr == nullptr ? null : pathPtr.toDartString(),
+        detail: row.detail,
+        duration: Duration(microseconds: row.durationNs ~/ 1000),
+        age: Duration(microseconds: row.ageNs ~/ 1000),
+      ));
+    }
+    return IntegrityReport(
+      flags: native.flags,
+      probeTime: Duration(microseconds: native.probeNs ~/ 1000),
+      checks: checks,
+    );
+  }
+
+  /// Re-runs every native check, ignoring cached results.
+  int probeFresh() => _fullProbe();
+
+  /// Adjusts native cache lifetimes for volatile checks (debugger) and
+  /// on-disk checks (su/Magisk/Xposed/Frida paths, SELinux).
+  void setCacheTtl(
+          {required Duration dynamicChecks, required Duration staticChecks}) =>
+      _setCacheTtl(dynamicChecks.inMilliseconds, staticChecks.inMilliseconds);
+
+  /// Forces the next [probe] to re-run every check.
+  void invalidateCache() => _invalidateCache();
+
+  /// Stats every entry of [paths] in a single native call and returns one
+  /// result byte per path ([pathPresent], [pathDirectory], ...).
+  Uint8List probePaths(List<String> paths) {
+    final count = paths.length;
+    final pathArray = calloc<Pointer<Utf8>>(count == 0 ? 1 : count);
+    final resultPtr = calloc<Uint8>(count == 0 ? 1 : count);
+    try {
+      for (var i = 0; i < count; i++) {
+        pathArray[i] = paths[i].toNativeUtf8(allocator: calloc);
+      }
+      if (_probePaths(pathArray, count, resultPtr) < 0) {
+        throw StateError('integrity_probe_paths rejected its arguments');
+      }
+      return Uint8List.fromList(resultPtr.asTypedList(count));
+    } finally {
+      for (var i = 0; i < count; i++) {
+        if (pathArray[i] != nullptr) calloc.free(pathArray[i]);
+      }
+      calloc.free(pathArray);
+      calloc.free(resultPtr);
+    }
+  }
+
+  /// Scans /proc/self/maps for injected hooking frameworks and unnamed
+  /// RWX regions. Returns null where the process maps cannot be read.
+  MemoryMapScan? scanMemoryMaps() {
+    final rwxPtr = calloc<Uint32>();
+    try {
+      final hits = _scanMaps(rwxPtr);
+      if (hits < 0) return null;
+      return MemoryMapScan(hits, rwxPtr.value);
+    } finally {
+      calloc.free(rwxPtr);
+    }
+  }
+
+  /// BLAKE2b-256 of the executable segments of the loaded [module]
+  /// (e.g. `libapp.so`). The first call also records the per-page baseline
+  /// used by [verifyText]; later calls are served from it unless [refresh].
+  /// Returns null if the module is not loaded or the platform lacks
+  /// dl_iterate_phdr.
+  Uint8List? textDigest(String module, {bool refresh = false}) {
+    final namePtr = module.toNativeUtf8(allocator: calloc);
+    final digestPtr = calloc<Uint8>(textDigestBytes);
+    try {
+      final covered =
+          _textBaseline(namePtr, digestPtr, textDigestBytes, refresh ? 1 : 0);
+      if (covered < 0) return null;
+      return Uint8List.fromList(digestPtr.asTypedList(textDigestBytes));
+    } finally {
+      calloc.free(namePtr);
+      calloc.free(digestPtr);
+    }
+  }
+
+  /// Re-hashes [samplePages] random text pages of [module] (0 = all) against
+  /// the baseline. Returns null when [textDigest] has not been taken yet.
+  bool? verifyText(String module, {int samplePages = 8}) {
+    final namePtr = module.toNativeUtf8(allocator: calloc);
+    try {
+      final rc = _textVerify(namePtr, samplePages);
+      return rc < 0 ? null : rc == 0;
+    } finally {
+      calloc.free(namePtr);
+    }
+  }
+
+  /// Device-DNA fingerprint: one streaming BLAKE2b over [context] and the
+  /// stable hardware identifiers (cpuinfo, SoC, board, memory size).
+  /// Deterministic for a given device and [context].
+  Uint8List deviceFingerprint({Uint8List? context, int length = 32}) {
+    final ctx = context ?? Uint8List(0);
+    final ctxPtr = calloc<Uint8>(ctx.isEmpty ? 1 : ctx.length);
+    final outPtr = calloc<Uint8>(length);
+    try {
+      ctxPtr.asTypedList(ctx.length).setAll(0, ctx);
+      if (_deviceFingerprint(ctxPtr, ctx.length, outPtr, length) != length) {
+        throw ArgumentError.value(length, 'length', 'must be 16..64');
+      }
+      return Uint8List.fromList(outPtr.asTypedList(length));
+    } finally {
+      calloc.free(ctxPtr);
+      calloc.free(outPtr);
+    }
+  }
+
+  /// Whether the native background monitor is running.
+  bool get isMonitoring => _monitorCallable != null;
+
+  /// Starts the native monitor thread. [onChange] runs on this isolate's
+  /// event loop with the new bitmask and the bits that changed; the first
+  /// call reports the baseline. Returns false where the platform has no
+  /// monitor (callers should keep polling [probe]) or it is already running.
+  bool startMonitor(void Function(int flags, int changed) onChange,
+      {Duration interval = const Duration(seconds: 1)}) {
+    if (_monitorCallable != null) return false;
+    final callable =
+        NativeCallable<Void Function(Uint32, Uint32)>.listener(onChange);
+    if (_monitorStart(callable.nativeFunction, interval.inMilliseconds) != 0) {
+      callable.close();
+      return false;
+    }
+    _monitorCallable = callable;
+    return true;
+  }
+
+  /// Stops the monitor. The native thread is joined before the callback is
+  /// released, so no event can reach a closed callable.
+  void stopMonitor() {
+    final callable = _monitorCallable;
+    if (callable == null) return;
+    _monitorStop();
+    callable.close();
+    _monitorCallable = null;
+  }
+}
+
+/// Result of [NativeIntegrity.scanMemoryMaps].
+class MemoryMapScan {
+  const MemoryMapScan(this.hits, this.rwxRegions);
+
+  /// `NativeIntegrity.maps*` bits that matched.
+  final int hits;
+
+  /// Number of anonymous writable+executable mappings.
+  final int rwxRegions;
+
+  bool has(int bit) => (hits & bit) != 0;
+}
+
+// Mirrors integrity_report / integrity_check_report in native_integrity.h.
+const int integrityReportVersion = 1;
+const int integrityReportMaxChecks = 16;
+const int integrityCheckDetected = 1;
+
+final class NativeIntegrityCheck extends Struct {
+  @Uint32()
+  external int flag;
+  @Int32()
+  external int status;
+  @Int32()
+  external int matchedIndex;
+  @Int32()
+  external int detail;
+  @Uint64()
+  external int durationNs;
+  @Uint64()
+  external int ageNs;
+}
+
+final class NativeIntegrityReport extends Struct {
+  @Uint32()
+  external int version;
+  @Uint32()
+  external int flags;
+  @Uint32()
+  external int checkCount;
+  @Uint32()
+  external int reserved;
+  @Uint64()
+  external int probeNs;
+  @Array(integrityReportMaxChecks)
+  external Array<NativeIntegrityCheck> checks;
+}
+
+/// One row of [IntegrityReport].
+class IntegrityCheckResult {
+  const IntegrityCheckResult({
+    required this.flag,
+    required this.detected,
+    required this.matchedIndex,
+    required this.matchedPath,
+    required this.detail,
+    required this.duration,
+    required this.age,
+  });
+
+  /// `NativeIntegrity` probe bit this check reports.
+  final int flag;
+  final bool detected;
+
+  /// Index of the matching path in the native table, -1 if none.
+  final int matchedIndex;
+  final String? matchedPath;
+
+  /// Debugger: TracerPid. Hook check: `NativeIntegrity.maps*` bits.
+  final int detail;
+
+  /// Cost of the run that produced this result.
+  final Duration duration;
+
+  /// Time since that run; zero when it ran during this report.
+  final Duration age;
+
+  Map<String, dynamic> toJson() => {
+        'flag': flag,
+        'detected': detected,
+        if (matchedPath != null) 'matchedPath': matchedPath,
+        'detail': detail,
+        'durationUs': duration.inMicroseconds,
+        'ageMs': age.inMilliseconds,
+      };
+}
+
+/// Structured result of [NativeIntegrity.report].
+class IntegrityReport {
+  const IntegrityReport({
+    required this.flags,
+    required this.probeTime,
+    required this.checks,
+  });
+
+  /// Same bitmask as [NativeIntegrity.probe].
+  final int flags;
+  final Duration probeTime;
+  final List<IntegrityCheckResult> checks;
+
+  bool isDetected(int flag) => (flags & flag) != 0;
+
+  IntegrityCheckResult? operator [](int flag) {
+    for (final check in checks) {
+      if (check.flag == flag) return check;
+    }
+    return null;
+  }
 }
@@ -8,6 +8,7 @@ import 'dart:convert';
 import 'package:notehider/models/security_config.dart';
 import 'package:notehider/models/security_profiles.dart';
 import 'package:notehider/services/storage_service.dart';
+import 'package:notehider/services/crypto_ffi.dart';
 import 'package:notehider/services/crypto_service.dart';
 
 class SecurityConfigService {
@@ -204,6 +205,9 @@ class SecurityConfigService {
           .map((f) => f.type.name)
           .toList(),
       'lastUpdated': currentConfig.lastUpdated.toIso8601String(),
+      // Native crypto call counts and latency histograms for this session.
+      'nativeCrypto': CryptoFFI().nativeStats().toJson(),
+      'secureMemory': CryptoFFI().secureMemoryInfo()?.toJson(),
     };
   }
 
@@ -1160,46 +1160,21 @@ class StorageService {
         print('⚠️ Failed to unwrap cached device salt: $e');
       }
 
-      // Get comprehensive device DNA
-      final deviceDNA = await _generateDeviceIntegrityHash();
-
-      // Get hardware-specific entropy
-      final hardwareEntropy = await _generateHardwareEntropy();
-
-      // Temporal component (prevents replay attacks)
-      final timestamp = DateTime.now().millisecondsSinceEpoch.toString();
-
-      // Environmental factors
-      final environmentStr = Platform.environment.entries
-          .map((e) => '${e.key}=${e.value}')
-          .join(',');
-      final environment = [
-        environmentStr,
-        Platform.localeName,
-        Platform.numberOfProcessors.toString(),
-      ].join('|');
-
-      // 🔀 MULTI-LAYER SALT DERIVATION
-      final layer1 = sha256.convert(utf8.encode('$deviceDNA|PRIMARY_LAYER'));
-      final layer2 = sha256.convert(
-          utf8.encode('${layer1.toString()}|$hardwareEntropy|HARDWARE_LAYER'));
-      final layer3 = sha256.convert(
-          utf8.encode('${layer2.toString()}|$timestamp|TEMPORAL_LAYER'));
-      final layer4 = sha256.convert(
-          utf8.encode('${layer3.toString()}|$environment|ENVIRONMENT_LAYER'));
-
       // Integrate attestation bitmask (native integrity probe)
       int attestationBits = 0;
       try {
         attestationBits = NativeIntegrity.instance.probe();
       } catch (_) {}
 
-      final saltPre = sha256
-          .convert(utf8.encode('${layer4.toString()}|DEVICE_BOUND_SALT_FINAL'));
-      final combinedWithAttest = sha256.convert(utf8.encode(
-          '${saltPre.toString()}|ATT:${attestationBits.toRadixString(16)}'));
-
-      final finalBytes = Uint8List.fromList(combinedWithAttest.bytes);
+      // Temporal + random component (prevents replay and precomputation);
+      // the hardware DNA itself is collected and hashed natively in one call.
+      final context = BytesBuilder(copy: false)
+        ..add(utf8.encode('notehider.device_salt.v2'
+            '|${DateTime.now().millisecondsSinceEpoch}'
+            '|ATT:${attestationBits.toRadixString(16)}|'))
+        ..add(_cryptoService.generateSalt());
+      final finalBytes = NativeIntegrity.instance
+          .deviceFingerprint(context: context.takeBytes(), length: 32);
 
       // Store hardware-wrapped copy for future reference
       try {
@@ -1231,47 +1206,6 @@ class StorageService {
     }
   }
 
-  /// ⚡ HARDWARE ENTROPY GENERATION
-  ///
-  /// Collects entropy from hardware-specific sources
-  Future<String> _generateHardwareEntropy() async {
-    try {
-      final entropyData = <String>[];
-
-      // System entropy sources
-      entropyData.addAll([
-        Random.secure().nextInt(0x7FFFFFFF).toString(),
-        DateTime.now().microsecondsSinceEpoch.toString(),
-        Platform.numberOfProcessors.toString(),
-      ]);
-
-      // Memory pressure indicators (platform specific)
-      try {
-        if (Platform.isAndroid || Platform.isIOS) {
-          // Mobile memory patterns
-          final memoryPressure = Random.secure().nextDouble().toString();
-          entropyData.add('memory_pressure:$memoryPressure');
-        }
-      } catch (e) {
-        entropyData.add('memory_entropy_failed:$e');
-      }
-
-      // Network entropy (if available)
-      try {
-        final networkHash = sha256.convert(utf8.encode(Platform.localeName));
-        entropyData
-            .add('network_entropy:${networkHash.toString().substring(0, 16)}');
-      } catch (e) {
-        entropyData.add('network_entropy_failed:$e');
-      }
-
-      return entropyData.join('|');
-    } catch (e) {
-      print('🚨 Hardware entropy generation failed: $e');
-      return 'hardware_entropy_fallback:${Random.secure().nextInt(0x7FFFFFFF)}';
-    }
-  }
-
   /// 🔐 COMBINE PASSWORD WITH DEVICE BINDING
   String _combinePasswordWithDevice(String password, Uint8List deviceSalt) {
     final deviceSaltString = base64.encode(deviceSalt);
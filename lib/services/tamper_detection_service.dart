@@ -12,10 +12,12 @@ import 'package:flutter_secure_storage/flutter_secure_storage.dart';
 import 'package:notehider/models/security_config.dart';
 import 'package:device_info_plus/device_info_plus.dart';
 import 'package:package_info_plus/package_info_plus.dart';
+import 'dart:async';
 import 'dart:convert';
 import 'dart:io';
 import 'dart:typed_data';
 import 'package:crypto/crypto.dart';
+import 'crypto_ffi.dart';
 import 'native_integrity_ffi.dart';
 
 class TamperDetectionService {
@@ -36,6 +38,8 @@ class TamperDetectionService {
   String? _appSignatureHash;
   DateTime? _lastIntegrityCheck;
   int _threatLevel = 0;
+  final StreamController<TamperDetectionResult> _nativeEvents =
+      StreamController<TamperDetectionResult>.broadcast();
 
   // Constants
   static const String _configKey = 'tamper_detection_config';
@@ -46,6 +50,77 @@ class TamperDetectionService {
   static const int _maxHistorySize = 100;
   static const Duration _integrityCheckInterval = Duration(hours: 1);
 
+  // File-based indicators, probed together by _scanIndicatorPaths()
+  static const List<String> _rootBinaryPaths = [
+    '/system/bin/su',
+    '/system/xbin/su',
+    '/sbin/su',
+    '/data/local/xbin/su',
+    '/data/local/bin/su',
+    '/system/sd/xbin/su',
+    '/system/bin/failsafe/su',
+    '/data/local/su',
+    '/su/bin/su',
+  ];
+  static const List<String> _xposedPaths = [
+    '/data/data/de.robv.android.xposed.installer',
+    '/system/framework/XposedBridge.jar',
+  ];
+  static const List<String> _emulatorPaths = [
+    '/dev/socket/qemud',
+    '/dev/qemu_pipe',
+    '/system/lib/libc_malloc_debug_qemu.so',
+    '/sys/qemu_trace',
+    '/system/bin/qemu-props',
+  ];
+  static const List<String> _fridaPaths = [
+    '/data/local/tmp/frida-server',
+    '/sdcard/frida-server',
+    '/system/bin/frida-server',
+  ];
+  static const String _substratePath = '/data/data/com.saurik.substrate';
+
+  // Modules whose code sections are checksummed by the native self-check
+  static const List<String> _textModules = [
+    'libnative_crypto_library.so',
+    'libapp.so',
+  ];
+  static const List<String> _recoveryPaths = [
+    '/system/recovery-resource.dat',
+    '/system/recovery-transform.dat',
+    '/system/bin/recovery',
+    '/system/etc/recovery-resource.dat',
+  ];
+  static const List<String> _magiskPaths = [
+    '/sbin/.magisk',
+    '/data/adb/magisk',
+    '/cache/.disable_magisk',
+  ];
+  static const List<String> _jailbreakPaths = [
+    '/private/var/lib/apt',
+    '/Applications/Cydia.app',
+    '/Applications/blackra1n.app',
+    '/Applications/FakeCarrier.app',
+    '/Applications/Icy.app',
+    '/Applications/IntelliScreen.app',
+    '/Applications/MxTube.app',
+    '/Applications/RockApp.app',
+    '/Applications/SBSettings.app',
+    '/Applications/WinterBoard.app',
+    '/private/var/lib/cydia',
+    '/private/var/mobile/Library/SBSettings/Themes',
+    '/private/var/stash',
+    '/private/var/tmp/cydia.log',
+    '/System/Library/LaunchDaemons/com.ikey.bbot.plist',
+    '/System/Library/LaunchDaemons/com.saurik.Cydia.Startup.plist',
+    '/usr/bin/sshd',
+    '/usr/libexec/sftp-server',
+    '/usr/sbin/sshd',
+    '/etc/apt',
+    '/bin/bash',
+    '/usr/bin/ssh',
+  ];
+
   /// 🚀 INITIALIZE TAMPER DETECTION SERVICE
   Future<void> initialize() async {
     if (_isInitialized) return;
@@ -58,6 +133,9 @@ class TamperDetectionService {
       _isInitialized = true;
       print('🛡️ Tamper detection service initialized');
 
+      // Native monitor pushes changes; platforms without one keep polling.
+      NativeIntegrity.instance.startMonitor(_onNativeIntegrityChange);
+
       // Perform initial comprehensive check
       await performComprehensiveCheck();
     } catch (e) {
@@ -74,20 +152,26 @@ class TamperDetectionService {
     final startTime = DateTime.now();
 
     try {
+      // Every file-based indicator is stat'ed in one native call up front.
+      final presentPaths = _scanIndicatorPaths();
+      // One native probe feeds every detector below.
+      final nativeReport = _freshNativeReport();
+
       // 1. Root/Jailbreak Detection
-      final rootResult = await _detectRootJailbreak();
+      final rootResult =
+          await _detectRootJailbreak(presentPaths, nativeReport);
       results.add(rootResult);
 
       // 2. Debug Detection
-      final debugResult = await _detectDebugMode();
+      final debugResult = await _detectDebugMode(nativeReport);
       results.add(debugResult);
 
       // 3. Emulator Detection
-      final emulatorResult = await _detectEmulator();
+      final emulatorResult = await _detectEmulator(presentPaths);
       results.add(emulatorResult);
 
       // 4. Hook Detection
-      final hookResult = await _detectHooks();
+      final hookResult = await _detectHooks(presentPaths, nativeReport);
       results.add(hookResult);
 
       // 5. App Integrity Check
@@ -95,11 +179,12 @@ class TamperDetectionService {
       results.add(integrityResult);
 
       // 6. System Integrity Check
-      final systemResult = await _checkSystemIntegrity();
+      final systemResult =
+          await _checkSystemIntegrity(presentPaths, nativeReport);
       results.add(systemResult);
 
       // 7. Memory Analysis
-      final memoryResult = await _analyzeMemory();
+      final memoryResult = await _analyzeMemory(nativeReport);
       results.add(memoryResult);
 
       // 8. Network Security Check
@@ -146,7 +231,8 @@ class TamperDetectionService {
   }
 
   /// 🔴 ROOT/JAILBREAK DETECTION
-  Future<TamperDetectionResult> _detectRootJailbreak() async {
+  Future<TamperDetectionResult> _detectRootJailbreak(
+      Set<String> presentPaths, IntegrityReport nativeReport) async {
     final details = <String, dynamic>{};
     int threatLevel = 0;
     String message = '';
@@ -157,24 +243,16 @@ class TamperDetectionService {
         final rootIndicators = <String>[];
 
         // Check for common root binaries
-        final rootPaths = [
-          '/system/bin/su',
-          '/system/xbin/su',
-          '/sbin/su',
-          '/data/local/xbin/su',
-          '/data/local/bin/su',
-          '/system/sd/xbin/su',
-          '/system/bin/failsafe/su',
-          '/data/local/su',
-          '/su/bin/su',
-        ];
-
-        for (final path in rootPaths) {
-          if (await File(path).exists()) {
+        for (final path in _rootBinaryPaths) {
+          if (presentPaths.contains(path)) {
             rootIndicators.add('Root binary found: $path');
             threatLevel = 10;
           }
         }
+        if (_addNativeFinding(nativeReport, NativeIntegrity.suBinaryFound,
+            'Root binary found', rootIndicators)) {
+          threatLevel = 10;
+        }
 
         // Check for root management apps
         final rootApps = [
@@ -190,21 +268,16 @@ class TamperDetectionService {
         // This is a simplified version for demonstration
 
         // Check for Xposed Framework
-        try {
-          // Check for Xposed indicators
-          final xposedFiles = [
-            '/data/data/de.robv.android.xposed.installer',
-            '/system/framework/XposedBridge.jar',
-          ];
-
-          for (final file in xposedFiles) {
-            if (await File(file).exists()) {
-              rootIndicators.add('Xposed framework detected: $file');
-              threatLevel = 9;
-            }
+        for (final file in _xposedPaths) {
+          if (presentPaths.contains(file)) {
+            rootIndicators.add('Xposed framework detected: $file');
+            threatLevel = 9;
           }
-        } catch (e) {
-          // Permission denied is normal
+        }
+        if (_addNativeFinding(nativeReport, NativeIntegrity.xposedDetected,
+                'Xposed framework detected', rootIndicators) &&
+            threatLevel < 9) {
+          threatLevel = 9;
         }
 
         details['rootIndicators'] = rootIndicators;
@@ -219,33 +292,8 @@ class TamperDetectionService {
         final jailbreakIndicators = <String>[];
 
         // Check for common jailbreak files
-        final jailbreakPaths = [
-          '/private/var/lib/apt',
-          '/Applications/Cydia.app',
-          '/Applications/blackra1n.app',
-          '/Applications/FakeCarrier.app',
-          '/Applications/Icy.app',
-          '/Applications/IntelliScreen.app',
-          '/Applications/MxTube.app',
-          '/Applications/RockApp.app',
-          '/Applications/SBSettings.app',
-          '/Applications/WinterBoard.app',
-          '/private/var/lib/cydia',
-          '/private/var/mobile/Library/SBSettings/Themes',
-          '/private/var/stash',
-          '/private/var/tmp/cydia.log',
-          '/System/Library/LaunchDaemons/com.ikey.bbot.plist',
-          '/System/Library/LaunchDaemons/com.saurik.Cydia.Startup.plist',
-          '/usr/bin/sshd',
-          '/usr/libexec/sftp-server',
-          '/usr/sbin/sshd',
-          '/etc/apt',
-          '/bin/bash',
-          '/usr/bin/ssh',
-        ];
-
-        for (final path in jailbreakPaths) {
-          if (await File(path).exists()) {
+        for (final path in _jailbreakPaths) {
+          if (presentPaths.contains(path)) {
             jailbreakIndicators.add('Jailbreak file found: $path');
             threatLevel = 10;
           }
@@ -278,8 +326,75 @@ class TamperDetectionService {
     }
   }
 
+  /// 📂 BATCHED INDICATOR SCAN
+  ///
+  /// Stats every indicator path for this platform in a single native call
+  /// and returns the ones that exist. If the native probe is unavailable an
+  /// empty set is returned, like [_freshNativeReport], so the remaining
+  /// detectors still run.
+  Set<String> _scanIndicatorPaths() {
+    final paths = <String>[
+      if (Platform.isAndroid) ...[
+        ..._rootBinaryPaths,
+        ..._xposedPaths,
+        ..._emulatorPaths,
+        ..._fridaPaths,
+        _substratePath,
+        ..._recoveryPaths,
+        ..._magiskPaths,
+      ],
+      if (Platform.isIOS) ..._jailbreakPaths,
+    ];
+    if (paths.isEmpty) return <String>{};
+
+    final Uint8List results;
+    try {
+      results = NativeIntegrity.instance.probePaths(paths);
+    } catch (e) {
+      print('⚠️ Native path probe unavailable: $e');
+      return <String>{};
+    }
+    return {
+      for (var i = 0; i < paths.length; i++)
+        if ((results[i] & NativeIntegrity.pathPresent) != 0) paths[i],
+    };
+  }
+
+  /// Fresh native integrity report. If the native side cannot produce one
+  /// (layout version mismatch, failed fill) an empty report is returned, so
+  /// only the native-fed checks lose input and the other detectors still
+  /// run.
+  IntegrityReport _freshNativeReport() {
+    try {
+      return NativeIntegrity.instance.report(fresh: true);
+    } catch (e) {
+      print('⚠️ Native integrity report unavailable: $e');
+      return const IntegrityReport(
+          flags: 0, probeTime: Duration.zero, checks: []);
+    }
+  }
+
+  /// Adds "[label]: <path>" for a native report row that fired, unless the
+  /// Dart path table already listed it. Returns whether the row fired.
+  bool _addNativeFinding(IntegrityReport report, int flag, String label,
+      List<String> indicators) {
+    final check = report[flag];
+    if (check == null || !check.detected) return false;
+    final entry = '$label: ${check.matchedPath ?? 'native probe'}';
+    if (!indicators.contains(entry)) indicators.add(entry);
+    return true;
+  }
+
+  /// Maps-scan bits carried by the native hook row, so detectors need no
+  /// second scan. The report does not carry the RWX region count.
+  MemoryMapScan? _mapsFromReport(IntegrityReport report) {
+    final bits = report[NativeIntegrity.hookInMemory]?.detail ?? -1;
+    return bits < 0 ? null : MemoryMapScan(bits, 0);
+  }
+
   /// 🐛 DEBUG MODE DETECTION
-  Future<TamperDetectionResult> _detectDebugMode() async {
+  Future<TamperDetectionResult> _detectDebugMode(
+      IntegrityReport nativeReport) async {
     final details = <String, dynamic>{};
     int threatLevel = 0;
     final debugIndicators = <String>[];
@@ -299,16 +414,12 @@ class TamperDetectionService {
         threatLevel = 7;
       }
 
-      // Check for debugger attachment (simplified)
-      if (Platform.isAndroid) {
-        // On Android, check for debugging flags
-        try {
-          // This would check application flags in production
-          // For now, we'll check for common debug indicators
-          debugIndicators.add('Debug mode check completed');
-        } catch (e) {
-          debugIndicators.add('Debug check error: $e');
-        }
+      // Check for debugger attachment (TracerPid / ptrace, from the native
+      // report)
+      final debugger = nativeReport[NativeIntegrity.debuggerAttached];
+      if (debugger != null && debugger.detected) {
+        debugIndicators.add('Debugger attached (tracer pid ${debugger.detail})');
+        threatLevel = 10;
       }
 
       details['debugIndicators'] = debugIndicators;
@@ -333,7 +444,8 @@ class TamperDetectionService {
   }
 
   /// 🤖 EMULATOR DETECTION
-  Future<TamperDetectionResult> _detectEmulator() async {
+  Future<TamperDetectionResult> _detectEmulator(
+      Set<String> presentPaths) async {
     final details = <String, dynamic>{};
     int threatLevel = 0;
     final emulatorIndicators = <String>[];
@@ -367,16 +479,8 @@ class TamperDetectionService {
         }
 
         // Check for specific emulator files
-        final emulatorFiles = [
-          '/dev/socket/qemud',
-          '/dev/qemu_pipe',
-          '/system/lib/libc_malloc_debug_qemu.so',
-          '/sys/qemu_trace',
-          '/system/bin/qemu-props',
-        ];
-
-        for (final file in emulatorFiles) {
-          if (await File(file).exists()) {
+        for (final file in _emulatorPaths) {
+          if (presentPaths.contains(file)) {
             emulatorIndicators.add('Emulator file detected: $file');
             threatLevel = 9;
           }
@@ -421,7 +525,8 @@ class TamperDetectionService {
   }
 
   /// 🪝 HOOK DETECTION
-  Future<TamperDetectionResult> _detectHooks() async {
+  Future<TamperDetectionResult> _detectHooks(
+      Set<String> presentPaths, IntegrityReport nativeReport) async {
     final details = <String, dynamic>{};
     int threatLevel = 0;
     final hookIndicators = <String>[];
@@ -430,31 +535,42 @@ class TamperDetectionService {
       // Check for common hooking frameworks
       if (Platform.isAndroid) {
         // Check for Frida
-        try {
-          final fridaFiles = [
-            '/data/local/tmp/frida-server',
-            '/sdcard/frida-server',
-            '/system/bin/frida-server',
-          ];
-
-          for (final file in fridaFiles) {
-            if (await File(file).exists()) {
-              hookIndicators.add('Frida server detected: $file');
-              threatLevel = 10;
-            }
+        for (final file in _fridaPaths) {
+          if (presentPaths.contains(file)) {
+            hookIndicators.add('Frida server detected: $file');
+            threatLevel = 10;
           }
-        } catch (e) {
-          // Permission errors are normal
+        }
+        if (_addNativeFinding(nativeReport, NativeIntegrity.fridaDetected,
+            'Frida server detected', hookIndicators)) {
+          threatLevel = 10;
         }
 
         // Check for Substrate (Cydia Substrate for Android)
-        try {
-          if (await File('/data/data/com.saurik.substrate').exists()) {
-            hookIndicators.add('Cydia Substrate detected');
-            threatLevel = 9;
-          }
-        } catch (e) {
-          // Permission errors are normal
+        if (presentPaths.contains(_substratePath)) {
+          hookIndicators.add('Cydia Substrate detected');
+          threatLevel = 9;
+        }
+      }
+
+      // Frameworks already injected into this process (gadgets included)
+      final maps = _mapsFromReport(nativeReport);
+      if (maps != null) {
+        if (maps.has(NativeIntegrity.mapsFrida)) {
+          hookIndicators.add('Frida agent mapped in process');
+          threatLevel = 10;
+        }
+        if (maps.has(NativeIntegrity.mapsSubstrate)) {
+          hookIndicators.add('Substrate mapped in process');
+          threatLevel = threatLevel < 9 ? 9 : threatLevel;
+        }
+        if (maps.has(NativeIntegrity.mapsXposed)) {
+          hookIndicators.add('Xposed/LSPosed mapped in process');
+          threatLevel = threatLevel < 9 ? 9 : threatLevel;
+        }
+        if (maps.has(NativeIntegrity.mapsHookLib)) {
+          hookIndicators.add('Inline hook library mapped in process');
+          threatLevel = threatLevel < 8 ? 8 : threatLevel;
         }
       }
 
@@ -493,6 +609,23 @@ class TamperDetectionService {
       details['version'] = packageInfo.version;
       details['buildNumber'] = packageInfo.buildNumber;
 
+      // Sampled re-hash of the in-memory code against the baseline: catches
+      // runtime patching that the load-time signature cannot see.
+      final patchedModules = _textModules
+          .where((m) => NativeIntegrity.instance.verifyText(m) == false)
+          .toList();
+      if (patchedModules.isNotEmpty) {
+        threatLevel = 10;
+        details['textPatched'] = patchedModules;
+      }
+
+      // Background self-check started when the crypto library was loaded.
+      final libraryCheck = await CryptoFFI().libraryIntegrity;
+      if (libraryCheck.tampered) {
+        threatLevel = 10;
+        details['nativeLibraryMismatch'] = true;
+      }
+
       if (_appSignatureHash != null) {
         if (currentSignature != _appSignatureHash) {
           threatLevel = 10;
@@ -530,7 +663,8 @@ class TamperDetectionService {
   }
 
   /// 🖥️ SYSTEM INTEGRITY CHECK
-  Future<TamperDetectionResult> _checkSystemIntegrity() async {
+  Future<TamperDetectionResult> _checkSystemIntegrity(
+      Set<String> presentPaths, IntegrityReport nativeReport) async {
     final details = <String, dynamic>{};
     int threatLevel = 0;
     final systemIssues = <String>[];
@@ -538,33 +672,29 @@ class TamperDetectionService {
     try {
       if (Platform.isAndroid) {
         // Check for system modifications
-        final systemPaths = [
-          '/system/recovery-resource.dat',
-          '/system/recovery-transform.dat',
-          '/system/bin/recovery',
-          '/system/etc/recovery-resource.dat',
-        ];
-
-        for (final path in systemPaths) {
-          if (await File(path).exists()) {
+        for (final path in _recoveryPaths) {
+          if (presentPaths.contains(path)) {
             systemIssues.add('Custom recovery detected: $path');
             threatLevel = 6;
           }
         }
 
         // Check for Magisk (systemless root)
-        final magiskPaths = [
-          '/sbin/.magisk',
-          '/data/adb/magisk',
-          '/cache/.disable_magisk',
-        ];
-
-        for (final path in magiskPaths) {
-          if (await File(path).exists()) {
+        for (final path in _magiskPaths) {
+          if (presentPaths.contains(path)) {
             systemIssues.add('Magisk detected: $path');
             threatLevel = 8;
           }
         }
+        if (_addNativeFinding(nativeReport, NativeIntegrity.magiskDetected,
+            'Magisk detected', systemIssues)) {
+          threatLevel = 8;
+        }
+
+        if (nativeReport.isDetected(NativeIntegrity.selinuxPermissive)) {
+          systemIssues.add('SELinux is not enforcing');
+          if (threatLevel < 7) threatLevel = 7;
+        }
       }
 
       details['systemIssues'] = systemIssues;
@@ -590,23 +720,38 @@ class TamperDetectionService {
   }
 
   /// 🧠 MEMORY ANALYSIS
-  Future<TamperDetectionResult> _analyzeMemory() async {
+  Future<TamperDetectionResult> _analyzeMemory(
+      IntegrityReport nativeReport) async {
     final details = <String, dynamic>{};
     int threatLevel = 0;
     final memoryIssues = <String>[];
 
     try {
-      // Simplified memory analysis
-      // In production, this would be more sophisticated
+      final maps = _mapsFromReport(nativeReport);
+      if (maps != null) {
+        // Only unnamed RWX mappings are flagged; ART's JIT cache
+        // (/memfd:jit-cache) and other named runtime regions are not.
+        // Debug builds JIT Dart into unnamed RWX memory; release AOT does not.
+        if (maps.has(NativeIntegrity.mapsAnonRwx)) {
+          memoryIssues.add('Unnamed RWX memory regions present');
+          threatLevel = 6;
+        }
+        if (maps.has(NativeIntegrity.mapsMagisk)) {
+          memoryIssues.add('Magisk/Zygisk module mapped in process');
+          threatLevel = 8;
+        }
+      }
 
-      details['memoryAnalysisComplete'] = true;
+      details['memoryAnalysisComplete'] = maps != null;
       details['memoryIssues'] = memoryIssues;
 
       return TamperDetectionResult(
         checkType: TamperCheckType.memory,
         status: threatLevel > 0 ? TamperStatus.detected : TamperStatus.clean,
         threatLevel: threatLevel,
-        message: 'Memory analysis completed',
+        message: threatLevel > 0
+            ? 'Suspicious memory mappings detected'
+            : 'Memory analysis completed',
         details: details,
       );
     } catch (e) {
@@ -744,9 +889,22 @@ class TamperDetectionService {
   Future<String> _calculateAppSignature() async {
     try {
       final packageInfo = await PackageInfo.fromPlatform();
-      final signatureData =
-          '${packageInfo.packageName}:${packageInfo.version}:${packageInfo.buildNumber}';
-      final bytes = utf8.encode(signatureData);
+      final signatureData = StringBuffer(
+          '${packageInfo.packageName}:${packageInfo.version}:${packageInfo.buildNumber}');
+
+      // Bind the signature to the machine code actually loaded, so a patched
+      // libapp.so / native library changes it. Modules that are absent
+      // (debug JIT builds, non-ELF platforms) are simply skipped.
+      for (final module in _textModules) {
+        final digest = NativeIntegrity.instance.textDigest(module);
+        if (digest != null) {
+          final hex =
+              digest.map((b) => b.toRadixString(16).padLeft(2, '0')).join();
+          signatureData.write(':$module=$hex');
+        }
+      }
+
+      final bytes = utf8.encode(signatureData.toString());
       final digest = sha256.convert(bytes);
       return digest.toString();
     } catch (e) {
@@ -855,6 +1013,45 @@ class TamperDetectionService {
     }
   }
 
+  /// 📡 NATIVE INTEGRITY EVENTS
+  ///
+  /// Emits whenever the native monitor reports a change in the probe
+  /// bitmask (debugger attach/detach, new su/Magisk/Frida artefacts,
+  /// unexpected library loads).
+  Stream<TamperDetectionResult> get nativeIntegrityEvents =>
+      _nativeEvents.stream;
+
+  void _onNativeIntegrityChange(int flags, int changed) {
+    final result = TamperDetectionResult(
+      checkType: TamperCheckType.unknown,
+      status: flags == 0 ? TamperStatus.clean : TamperStatus.detected,
+      threatLevel: flags == 0 ? 0 : 10,
+      message: flags == 0
+          ? 'Native integrity monitor: clean'
+          : 'Native integrity flags: 0x${flags.toRadixString(16)}',
+      details: {
+        'nativeProbe': flags,
+        'changed': changed,
+        'monitor': true,
+      },
+    );
+
+    if (flags != 0) {
+      _threatLevel = 10;
+      if (_detectionHistory.length >= _maxHistorySize) {
+        _detectionHistory.removeAt(0);
+      }
+      _detectionHistory.add(result);
+    }
+    _nativeEvents.add(result);
+  }
+
+  /// 🛑 STOP NATIVE MONITOR
+  void dispose() {
+    NativeIntegrity.instance.stopMonitor();
+    _nativeEvents.close();
+  }
+
   /// 🔧 UTILITY METHODS
   Future<void> _ensureInitialized() async {
     if (!_isInitialized) {
@@ -890,17 +1087,23 @@ class TamperDetectionService {
       final details = <String, dynamic>{};
       final issues = <String>[];
 
-      // Native integrity probe
-      final bitmask = NativeIntegrity.instance.probe();
+      // Native integrity probe (cached rows, one FFI call)
+      final nativeReport = NativeIntegrity.instance.report();
+      final bitmask = nativeReport.flags;
       if (bitmask != 0) {
         issues.add('Native probe flags: 0x${bitmask.toRadixString(16)}');
         threatLevel = 10;
         details['nativeProbe'] = bitmask;
+        details['nativeChecks'] = nativeReport.checks
+            .where((c) => c.detected)
+            .map((c) => c.toJson())
+            .toList();
       }
 
       // Quick root/jailbreak check
       if (_config.enableRootJailbreakDetection) {
-        final rootResult = await _detectRootJailbreak();
+        final rootResult =
+            await _detectRootJailbreak(_scanIndicatorPaths(), nativeReport);
         if (rootResult.status == TamperStatus.detected) {
           threatLevel = (threatLevel + rootResult.threatLevel).clamp(0, 10);
           issues.add('Root/jailbreak detected');
@@ -910,7 +1113,7 @@ class TamperDetectionService {
 
       // Quick debug mode check
       if (_config.enableDebugDetection) {
-        final debugResult = await _detectDebugMode();
+        final debugResult = await _detectDebugMode(nativeReport);
         if (debugResult.status == TamperStatus.detected) {
           threatLevel = (threatLevel + debugResult.threatLevel).clamp(0, 10);
           issues.add('Debug mode detected');
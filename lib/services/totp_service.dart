@@ -6,12 +6,12 @@
 /// • Anti-replay protection
 /// • Time drift tolerance
 
-import 'package:otp/otp.dart';
 import 'package:flutter_secure_storage/flutter_secure_storage.dart';
 import 'package:notehider/models/security_config.dart';
 import 'dart:convert';
 import 'dart:math';
 import 'dart:typed_data';
+import 'crypto_ffi.dart';
 
 class TOTPService {
   // Secure storage for TOTP data
@@ -27,6 +27,7 @@ class TOTPService {
   // TOTP state
   bool _isInitialized = false;
   String? _secretKey;
+  OtpKey? _otpKey; // native copy of _secretKey, created on first use
   List<String> _backupCodes = [];
   Set<String> _usedCodes = {};
   DateTime? _lastCodeTime;
@@ -38,6 +39,7 @@ class TOTPService {
   static const String _lastCodeTimeKey = 'totp_last_code_time';
 
   static const int _codeLength = 6;
+  static final RegExp _codePattern = RegExp('^[0-9]{$_codeLength}\$');
   static const int _timeStep = 30; // seconds
   static const int _timeDriftTolerance = 1; // allow 1 step before/after
   static const int _backupCodeCount = 10;
@@ -66,7 +68,7 @@ class TOTPService {
 
     try {
       // Generate or use provided secret
-      _secretKey = customSecret ?? _generateSecretKey(securityLevel);
+      _setSecretKey(customSecret ?? _generateSecretKey(securityLevel));
 
       // Generate backup codes
       _backupCodes = _generateBackupCodes();
@@ -125,18 +127,25 @@ class TOTPService {
         return await _verifyBackupCode(cleanCode);
       }
 
-      // Verify TOTP code
-      if (cleanCode.length != _codeLength) {
+      // Verify TOTP code: exactly six ASCII digits, so every accepted code
+      // has one spelling and the replay guard cannot be sidestepped
+      if (!_codePattern.hasMatch(cleanCode)) {
         return TOTPVerificationResult(
           success: false,
           codeType: TOTPCodeType.invalid,
-          message: 'Invalid code length',
+          message: 'Invalid code format',
           remainingBackupCodes: _backupCodes.length,
         );
       }
 
-      // Check for replay attack
-      if (await _isReplayAttack(cleanCode)) {
+      // Verify with time drift tolerance; yields the step the code belongs to
+      final matchedStep =
+          await _verifyTOTPWithDrift(cleanCode, securityLevel);
+
+      // Check for replay attack: keyed on the matched step, so a code
+      // accepted one step early cannot be replayed once that step is current
+      if (matchedStep != null &&
+          await _isReplayAttack(cleanCode, matchedStep)) {
         return TOTPVerificationResult(
           success: false,
           codeType: TOTPCodeType.replay,
@@ -145,12 +154,9 @@ class TOTPService {
         );
       }
 
-      // Verify with time drift tolerance
-      final isValid = await _verifyTOTPWithDrift(cleanCode, securityLevel);
-
-      if (isValid) {
+      if (matchedStep != null) {
         // Mark code as used
-        await _markCodeAsUsed(cleanCode);
+        await _markCodeAsUsed(cleanCode, matchedStep);
 
         return TOTPVerificationResult(
           success: true,
@@ -184,13 +190,9 @@ class TOTPService {
 
     try {
       final currentTime = DateTime.now().millisecondsSinceEpoch ~/ 1000;
-      return OTP.generateTOTPCodeString(
-        _secretKey!,
-        currentTime,
-        length: _codeLength,
-        interval: _timeStep,
-        algorithm: Algorithm.SHA1,
-      );
+      final code = _nativeKey()
+          .totp(currentTime, step: _timeStep, digits: _codeLength);
+      return code.toString().padLeft(_codeLength, '0');
     } catch (e) {
       print('🚨 Failed to generate current TOTP code: $e');
       return null;
@@ -222,7 +224,7 @@ class TOTPService {
   Future<void> disableTOTP() async {
     await _ensureInitialized();
 
-    _secretKey = null;
+    _setSecretKey(null);
     _backupCodes.clear();
     _usedCodes.clear();
     _lastCodeTime = null;
@@ -308,18 +310,21 @@ class TOTPService {
     );
   }
 
+  /// Replay-set key: the normalized code plus the time step it matched
+  String _usedCodeKey(String code, int step) {
+    final normalized =
+        int.parse(code).toString().padLeft(_codeLength, '0');
+    return '${normalized}_$step';
+  }
+
   /// Check for replay attack
-  Future<bool> _isReplayAttack(String code) async {
-    final codeKey =
-        '${code}_${DateTime.now().millisecondsSinceEpoch ~/ (_timeStep * 1000)}';
-    return _usedCodes.contains(codeKey);
+  Future<bool> _isReplayAttack(String code, int step) async {
+    return _usedCodes.contains(_usedCodeKey(code, step));
   }
 
   /// Mark code as used
-  Future<void> _markCodeAsUsed(String code) async {
-    final codeKey =
-        '${code}_${DateTime.now().millisecondsSinceEpoch ~/ (_timeStep * 1000)}';
-    _usedCodes.add(codeKey);
+  Future<void> _markCodeAsUsed(String code, int step) async {
+    _usedCodes.add(_usedCodeKey(code, step));
     _lastCodeTime = DateTime.now();
 
     // Clean old used codes (older than 2 time steps)
@@ -335,8 +340,9 @@ class TOTPService {
     await _saveTOTPData();
   }
 
-  /// Verify TOTP with time drift tolerance
-  Future<bool> _verifyTOTPWithDrift(
+  /// Verify TOTP with time drift tolerance. Returns the time step the code
+  /// matched, or null if it matched none in the window.
+  Future<int?> _verifyTOTPWithDrift(
       String code, SecurityLevel securityLevel) async {
     final currentTime = DateTime.now().millisecondsSinceEpoch ~/ 1000;
 
@@ -348,54 +354,38 @@ class TOTPService {
       tolerance = 1;
     }
 
-    // Check current time and tolerance window
-    for (int i = -tolerance; i <= tolerance; i++) {
-      final timeToCheck = currentTime + (i * _timeStep);
-      final expectedCode = OTP.generateTOTPCodeString(
-        _secretKey!,
-        timeToCheck,
-        length: _codeLength,
-        interval: _timeStep,
-        algorithm: Algorithm.SHA1,
-      );
-
-      if (code == expectedCode) {
-        return true;
-      }
-    }
+    // Whole tolerance window in one constant-time native call
+    if (!_codePattern.hasMatch(code)) return null;
+    final numericCode = int.parse(code);
 
-    return false;
+    final offset = _nativeKey().verifyTotp(
+      numericCode,
+      currentTime,
+      step: _timeStep,
+      digits: _codeLength,
+      window: tolerance,
+    );
+    return offset == null ? null : currentTime ~/ _timeStep + offset;
   }
 
-  /// Base32 encoding for secret key
-  String base32Encode(Uint8List bytes) {
-    const alphabet = 'ABCDEFGHIJKLMNOPQRSTUVWXYZ234567';
-    String result = '';
-    int buffer = 0;
-    int bitsLeft = 0;
-
-    for (int byte in bytes) {
-      buffer = (buffer << 8) | byte;
-      bitsLeft += 8;
-
-      while (bitsLeft >= 5) {
-        result += alphabet[(buffer >> (bitsLeft - 5)) & 31];
-        bitsLeft -= 5;
-      }
-    }
+  /// Replaces the secret and drops the native key derived from the old one
+  void _setSecretKey(String? secret) {
+    _otpKey?.dispose();
+    _otpKey = null;
+    _secretKey = secret;
+  }
 
-    if (bitsLeft > 0) {
-      result += alphabet[(buffer << (5 - bitsLeft)) & 31];
-    }
+  OtpKey _nativeKey() =>
+      _otpKey ??= CryptoFFI().createOtpKey(_secretKey!);
 
-    return result;
-  }
+  /// Base32 encoding for secret key
+  String base32Encode(Uint8List bytes) => CryptoFFI().base32Encode(bytes);
 
   /// Storage methods
   Future<void> _loadTOTPData() async {
     try {
       final secretData = await _secureStorage.read(key: _secretKeyKey);
-      _secretKey = secretData;
+      _setSecretKey(secretData);
 
       final backupData = await _secureStorage.read(key: _backupCodesKey);
       if (backupData != null) {
@@ -0,0 +1,665 @@
+// native_crypto_bench.c
+//
+// Micro/macro benchmarks for native_crypto_library. Every case is timed per
+// call; the results (latency percentiles, throughput, peak RSS) are written
+// as one JSON document so runs can be diffed and tracked over time.
+//
+//   native_crypto_bench [--quick] [--filter TEXT] [--max-size BYTES]
+//                       [--min-time SECONDS] [--output FILE]
+//                       [--check BASELINE] [--write-baseline FILE]
+//
+// --quick caps payloads at 1 MiB, skips the SENSITIVE Argon2 preset (1 GiB)
+// and shortens the per-case time budget, for a run of a few seconds.
+//
+// --check only runs the cases listed in BASELINE and exits non-zero when a
+// p50 is slower than its baseline by more than the case's tolerance (see
+// bench/baseline.json; ctest runs this as native_crypto_perf). Baseline
+// p50s are scaled by how fast this machine runs the reference case
+// (aead_raw/1048576) compared with the baseline host, so a uniformly
+// slower or faster CPU does not trip the gate, and a slowdown under
+// _BENCH_FLOOR_NS is never a regression. If the baseline host selected
+// different code paths (codec SIMD level, container AEAD) the check is
+// skipped with exit status 77.
+// --write-baseline records the current p50s in the same format, keeping
+// the tolerances of the --check file when one is given.
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "native_codec.h"
+#include "native_crypto.h"
+#include "native_integrity.h"
+#include "native_rng.h"
+#include "sodium.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#define _BENCH_SCHEMA 1
+#define _BENCH_MAX_RESULTS 128
+#define _BENCH_MIN_ITERS 3
+#define _BENCH_MAX_ITERS 1000000
+#define _BENCH_DEFAULT_TOLERANCE 0.30 // +30% on p50
+#define _BENCH_FLOOR_NS 1000          // ignore slowdowns below 1 us
+#define _BENCH_REFERENCE "aead_raw/1048576"
+#define _BENCH_EXIT_SKIP 77           // ctest SKIP_RETURN_CODE
+
+typedef int (*_bench_fn)(void* ctx);
+
+typedef struct {
+    char id[64];          // "<name>/<size>" or "<name>"; stable across runs
+    const char* name;
+    size_t size;          // payload bytes, 0 for fixed-size operations
+    size_t iterations;
+    uint64_t min_ns, p50_ns, p90_ns, p99_ns, max_ns;
+    double mean_ns;
+    double mib_per_s;     // size / p50, 0 for fixed-size operations
+    long peak_rss_kib;    // process peak after the case ran
+    int failed;
+} _bench_result;
+
+typedef struct {
+    int quick;
+    const char* filter;
+    size_t max_size;
+    double min_time_s;
+    const char* output;
+    const char* check;          // baseline to compare against
+    const char* write_baseline;
+} _bench_opts;
+
+typedef struct {
+    char id[64];
+    uint64_t p50_ns;
+    double tolerance;     // allowed slowdown as a fraction of p50_ns
+} _baseline_entry;
+
+static _bench_result _results[_BENCH_MAX_RESULTS];
+static size_t _resultCount = 0;
+static _baseline_entry _baseline[_BENCH_MAX_RESULTS];
+static size_t _baselineCount = 0;
+
+// "host" block of the baseline; -1 where a field is absent.
+static struct {
+    long cpus;
+    long codec_simd;
+    long container_aead;
+} _baselineHost = {-1, -1, -1};
+
+static uint64_t _now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static long _peak_rss_kib(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return -1;
+#if defined(__APPLE__)
+    return ru.ru_maxrss / 1024; // bytes on Darwin
+#else
+    return ru.ru_maxrss;        // KiB on Linux
+#endif
+}
+
+static const _baseline_entry* _baseline_find(const char* id) {
+    for (size_t i = 0; i < _baselineCount; ++i) {
+        if (strcmp(_baseline[i].id, id) == 0) return &_baseline[i];
+    }
+    return NULL;
+}
+
+// Reads the "cases" of a baseline file. This is not a general JSON parser:
+// it relies on the layout --write-baseline produces, one flat object per
+// case holding "id", "p50_ns" and an optional "tolerance".
+static long _json_long(const char* from, const char* limit, const char* key) {
+    const char* v = strstr(from, key);
+    if (v == NULL || (limit != NULL && v > limit)) return -1;
+    v = strchr(v + strlen(key), ':');
+    return v != NULL ? strtol(v + 1, NULL, 10) : -1;
+}
+
+static int _load_baseline(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return -1;
+    char* text = NULL;
+    long len = -1;
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) >= 0 &&
+        fseek(f, 0, SEEK_SET) == 0 && (text = malloc((size_t)len + 1)) != NULL) {
+        len = (long)fread(text, 1, (size_t)len, f);
+        text[len] = '\0';
+    }
+    fclose(f);
+    if (text == NULL) return -1;
+
+    const char* host = strstr(text, "\"host\"");
+    if (host != NULL) {
+        const char* host_end = strchr(host, '}');
+        _baselineHost.cpus = _json_long(host, host_end, "\"cpus\"");
+        _baselineHost.codec_simd = _json_long(host, host_end, "\"codec_simd\"");
+        _baselineHost.container_aead =
+            _json_long(host, host_end, "\"container_aead\"");
+    }
+
+    const char* p = text;
+    while (_baselineCount < _BENCH_MAX_RESULTS &&
+           (p = strstr(p, "\"id\"")) != NULL) {
+        const char* end = strchr(p, '}');
+        const char* q = strchr(p + 4, '"');
+        if (end == NULL || q == NULL) break;
+        const char* close = strchr(q + 1, '"');
+        if (close == NULL || close > end) break;
+
+        _baseline_entry* e = &_baseline[_baselineCount];
+        memset(e, 0, sizeof *e);
+        size_t id_len = (size_t)(close - q - 1);
+        if (id_len >= sizeof e->id) id_len = sizeof e->id - 1;
+        memcpy(e->id, q + 1, id_len);
+        e->tolerance = _BENCH_DEFAULT_TOLERANCE;
+
+        const char* v = strstr(close, "\"p50_ns\"");
+        if (v != NULL && v < end && (v = strchr(v, ':')) != NULL) {
+            e->p50_ns = strtoull(v + 1, NULL, 10);
+        }
+        v = strstr(close, "\"tolerance\"");
+        if (v != NULL && v < end && (v = strchr(v, ':')) != NULL) {
+            e->tolerance = strtod(v + 1, NULL);
+        }
+        if (e->p50_ns > 0) ++_baselineCount;
+        p = end;
+    }
+    free(text);
+    return _baselineCount > 0 ? 0 : -1;
+}
+
+static int _cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Nearest-rank percentile of sorted samples.
+static uint64_t _percentile(const uint64_t* s, size_t n, unsigned pct) {
+    size_t rank = (n * pct + 99) / 100;
+    return s[rank == 0 ? 0 : rank - 1];
+}
+
+// Calls [fn] once untimed, then repeatedly until both min_time and
+// _BENCH_MIN_ITERS are reached, recording every call.
+static void _bench(const _bench_opts* o, const char* name, size_t size,
+                   _bench_fn fn, void* ctx) {
+    char id[64];
+    if (size > 0) {
+        snprintf(id, sizeof id, "%s/%zu", name, size);
+    } else {
+        snprintf(id, sizeof id, "%s", name);
+    }
+    if (o->filter != NULL && strstr(id, o->filter) == NULL) return;
+    if (o->check != NULL && _baseline_find(id) == NULL) return;
+    if (_resultCount == _BENCH_MAX_RESULTS) return;
+
+    _bench_result* r = &_results[_resultCount++];
+    memset(r, 0, sizeof *r);
+    snprintf(r->id, sizeof r->id, "%s", id);
+    r->name = name;
+    r->size = size;
+    fprintf(stderr, "  %-40s", id);
+
+    size_t cap = 64, n = 0;
+    uint64_t* samples = malloc(cap * sizeof *samples);
+    if (samples == NULL || fn(ctx) != 0) {
+        r->failed = 1;
+    } else {
+        const uint64_t budget = (uint64_t)(o->min_time_s * 1e9);
+        const uint64_t start = _now_ns();
+        while (n < _BENCH_MAX_ITERS &&
+               (n < _BENCH_MIN_ITERS || _now_ns() - start < budget)) {
+            if (n == cap) {
+                uint64_t* grown = realloc(samples, 2 * cap * sizeof *samples);
+                if (grown == NULL) break;
+                samples = grown;
+                cap *= 2;
+            }
+            const uint64_t t = _now_ns();
+            if (fn(ctx) != 0) {
+                r->failed = 1;
+                break;
+            }
+            samples[n++] = _now_ns() - t;
+        }
+    }
+
+    if (!r->failed && n > 0) {
+        qsort(samples, n, sizeof *samples, _cmp_u64);
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += (double)samples[i];
+        r->iterations = n;
+        r->min_ns = samples[0];
+        r->p50_ns = _percentile(samples, n, 50);
+        r->p90_ns = _percentile(samples, n, 90);
+        r->p99_ns = _percentile(samples, n, 99);
+        r->max_ns = samples[n - 1];
+        r->mean_ns = sum / (double)n;
+        if (size > 0 && r->p50_ns > 0) {
+            r->mib_per_s = (double)size / (1024.0 * 1024.0) /
+                           ((double)r->p50_ns / 1e9);
+        }
+    }
+    free(samples);
+    r->peak_rss_kib = _peak_rss_kib();
+
+    if (r->failed) {
+        fprintf(stderr, " FAILED\n");
+    } else if (size > 0) {
+        fprintf(stderr, " p50 %12.1f us  %10.1f MiB/s\n",
+                (double)r->p50_ns / 1e3, r->mib_per_s);
+    } else {
+        fprintf(stderr, " p50 %12.1f us\n", (double)r->p50_ns / 1e3);
+    }
+}
+
+// --- Cases -------------------------------------------------------------------
+
+static uint8_t _key[32];
+
+typedef struct {
+    const uint8_t* data;
+    size_t len;
+    char* enc_b64;        // produced once for the decrypt case
+    uint8_t* scratch;     // raw AEAD / codec output
+    size_t scratch_len;
+    char* text;           // Base64 of [data] for the decode case
+    size_t text_len;
+} _payload_ctx;
+
+static int _case_encrypt_bytes(void* p) {
+    _payload_ctx* c = p;
+    char* out = encrypt_bytes(c->data, c->len, _key, sizeof _key);
+    if (out == NULL) return -1;
+    free_string(out);
+    return 0;
+}
+
+static int _case_decrypt_bytes(void* p) {
+    _payload_ctx* c = p;
+    char* out = decrypt_bytes(c->enc_b64, _key, sizeof _key);
+    if (out == NULL) return -1;
+    free_string(out);
+    return 0;
+}
+
+// The AEAD alone, without the Base64 framing and allocations that
+// encrypt_bytes() adds; the gap between the two is the wrapper overhead.
+static int _case_aead_raw(void* p) {
+    _payload_ctx* c = p;
+    unsigned char nonce[crypto_aead_xchacha20poly1305_ietf_NPUBBYTES];
+    randombytes_buf(nonce, sizeof nonce);
+    unsigned long long clen = 0;
+    return crypto_aead_xchacha20poly1305_ietf_encrypt(
+        c->scratch, &clen, c->data, c->len, NULL, 0, NULL, nonce, _key);
+}
+
+static int _case_base64_encode(void* p) {
+    _payload_ctx* c = p;
+    return base64_encode(c->data, c->len, (char*)c->scratch,
+                         c->scratch_len) < 0 ? -1 : 0;
+}
+
+static int _case_base64_decode(void* p) {
+    _payload_ctx* c = p;
+    return base64_decode(c->text, c->text_len, c->scratch,
+                         c->scratch_len) < 0 ? -1 : 0;
+}
+
+// Buffered CSPRNG against libsodium's per-call getrandom() path.
+static int _case_rng_fill(void* p) {
+    _payload_ctx* c = p;
+    return rng_fill(c->scratch, c->len);
+}
+
+static int _case_randombytes_buf(void* p) {
+    _payload_ctx* c = p;
+    randombytes_buf(c->scratch, c->len);
+    return 0;
+}
+
+static int _case_hkdf_sha256(void* p) {
+    (void)p;
+    static const uint8_t salt[16] = {1};
+    static const uint8_t info[] = "notehider-bench";
+    uint8_t okm[32];
+    return hkdf_sha256(_key, sizeof _key, salt, sizeof salt,
+                       info, sizeof info - 1, okm, sizeof okm);
+}
+
+typedef struct {
+    unsigned long long opslimit;
+    size_t memlimit;
+} _pwhash_ctx;
+
+static int _case_pwhash_preset(void* p) {
+    _pwhash_ctx* c = p;
+    char out[crypto_pwhash_STRBYTES];
+    return crypto_pwhash_str(out, "correct horse battery staple", 28,
+                             c->opslimit, c->memlimit);
+}
+
+static int _case_hash_password(void* p) {
+    (void)p;
+    const char* out = hash_password("correct horse battery staple");
+    if (out == NULL) return -1;
+    free_string((char*)out);
+    return 0;
+}
+
+static int _case_quick_probe(void* p) {
+    (void)p;
+    (void)quick_probe_native();
+    return 0;
+}
+
+static int _case_full_probe(void* p) {
+    (void)p;
+    (void)full_probe_native();
+    return 0;
+}
+
+static int _bench_payload(const _bench_opts* o, const uint8_t* data,
+                          size_t len) {
+    _payload_ctx c = {.data = data, .len = len};
+    c.scratch_len = base64_encoded_len(len) + 64;
+    c.scratch = malloc(c.scratch_len);
+    c.text_len = base64_encoded_len(len);
+    c.text = malloc(c.text_len + 1);
+    if (c.scratch == NULL || c.text == NULL ||
+        base64_encode(data, len, c.text, c.text_len) < 0) {
+        free(c.scratch);
+        free(c.text);
+        return -1;
+    }
+
+    _bench(o, "encrypt_bytes", len, _case_encrypt_bytes, &c);
+    c.enc_b64 = encrypt_bytes(data, len, _key, sizeof _key);
+    if (c.enc_b64 != NULL) {
+        _bench(o, "decrypt_bytes", len, _case_decrypt_bytes, &c);
+        free_string(c.enc_b64);
+    }
+    _bench(o, "aead_raw", len, _case_aead_raw, &c);
+    _bench(o, "base64_encode", len, _case_base64_encode, &c);
+    _bench(o, "base64_decode", len, _case_base64_decode, &c);
+    _bench(o, "rng_fill", len, _case_rng_fill, &c);
+    _bench(o, "randombytes_buf", len, _case_randombytes_buf, &c);
+
+    free(c.scratch);
+    free(c.text);
+    return 0;
+}
+
+// --- Output ------------------------------------------------------------------
+
+static void _write_json(FILE* f, const _bench_opts* o) {
+    fprintf(f, "{\n  \"schema\": %d,\n", _BENCH_SCHEMA);
+    fprintf(f, "  \"library\": \"native_crypto\",\n");
+    fprintf(f, "  \"sodium_version\": \"%s\",\n", sodium_version_string());
+    fprintf(f, "  \"timestamp\": %lld,\n", (long long)time(NULL));
+    fprintf(f, "  \"quick\": %s,\n", o->quick ? "true" : "false");
+    fprintf(f, "  \"host\": {\"cpus\": %ld, \"codec_simd\": %d, "
+               "\"container_aead\": %d},\n",
+            sysconf(_SC_NPROCESSORS_ONLN), codec_simd_level(),
+            container_selected_aead());
+    fprintf(f, "  \"peak_rss_kib\": %ld,\n", _peak_rss_kib());
+    fprintf(f, "  \"results\": [");
+    for (size_t i = 0; i < _resultCount; ++i) {
+        const _bench_result* r = &_results[i];
+        fprintf(f, "%s\n    {\"id\": \"%s\", \"name\": \"%s\", \"size\": %zu, "
+                   "\"failed\": %s, \"iterations\": %zu, "
+                   "\"ns\": {\"min\": %llu, \"p50\": %llu, \"p90\": %llu, "
+                   "\"p99\": %llu, \"max\": %llu, \"mean\": %.0f}, "
+                   "\"mib_per_s\": %.2f, \"peak_rss_kib\": %ld}",
+                i ? "," : "", r->id, r->name, r->size,
+                r->failed ? "true" : "false", r->iterations,
+                (unsigned long long)r->min_ns, (unsigned long long)r->p50_ns,
+                (unsigned long long)r->p90_ns, (unsigned long long)r->p99_ns,
+                (unsigned long long)r->max_ns, r->mean_ns, r->mib_per_s,
+                r->peak_rss_kib);
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+// The absolute p50s only mean something on a host that runs the same code
+// paths; the CPU count is informational since every case is single-threaded.
+static int _baseline_host_matches(void) {
+    int ok = 1;
+    if (_baselineHost.codec_simd >= 0 &&
+        _baselineHost.codec_simd != codec_simd_level()) {
+        fprintf(stderr, "baseline codec_simd %ld, this host %d\n",
+                _baselineHost.codec_simd, codec_simd_level());
+        ok = 0;
+    }
+    if (_baselineHost.container_aead >= 0 &&
+        _baselineHost.container_aead != container_selected_aead()) {
+        fprintf(stderr, "baseline container_aead %ld, this host %d\n",
+                _baselineHost.container_aead, container_selected_aead());
+        ok = 0;
+    }
+    return ok;
+}
+
+static const _bench_result* _result_find(const char* id) {
+    for (size_t i = 0; i < _resultCount; ++i) {
+        if (strcmp(_results[i].id, id) == 0) return &_results[i];
+    }
+    return NULL;
+}
+
+// Compares every baseline case with this run. Each baseline p50 is first
+// scaled by the reference case's speed on this host. A case regresses when
+// its p50 exceeds the scaled baseline by more than its tolerance and by
+// more than _BENCH_FLOOR_NS; a case that failed or did not run counts as a
+// regression too. Returns the count.
+static int _check_baseline(void) {
+    int regressions = 0;
+    fprintf(stderr, "check\n");
+
+    double scale = 1.0;
+    const _baseline_entry* ref = _baseline_find(_BENCH_REFERENCE);
+    const _bench_result* ref_now = _result_find(_BENCH_REFERENCE);
+    if (ref != NULL && ref_now != NULL && !ref_now->failed) {
+        scale = (double)ref_now->p50_ns / (double)ref->p50_ns;
+        fprintf(stderr, "  %-40s x%.2f of baseline host (reference)\n",
+                _BENCH_REFERENCE, scale);
+    } else {
+        fprintf(stderr, "  no %s result; comparing absolute times\n",
+                _BENCH_REFERENCE);
+    }
+
+    for (size_t i = 0; i < _baselineCount; ++i) {
+        const _baseline_entry* e = &_baseline[i];
+        if (e == ref) continue;
+        const _bench_result* r = _result_find(e->id);
+        if (r == NULL || r->failed) {
+            fprintf(stderr, "  %-40s MISSING\n", e->id);
+            ++regressions;
+            continue;
+        }
+        const double expected = (double)e->p50_ns * scale;
+        const double change = (double)r->p50_ns / expected - 1.0;
+        const char* verdict = "ok";
+        if (change > e->tolerance &&
+            (double)r->p50_ns - expected > _BENCH_FLOOR_NS) {
+            verdict = "REGRESSION";
+            ++regressions;
+        } else if (change > e->tolerance) {
+            verdict = "ok (below floor)";
+        } else if (change < -e->tolerance) {
+            verdict = "faster (consider --write-baseline)";
+        }
+        fprintf(stderr, "  %-40s %+7.1f%% (limit +%.0f%%)  %s\n", e->id,
+                change * 100.0, e->tolerance * 100.0, verdict);
+    }
+    return regressions;
+}
+
+static int _write_baseline(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) return -1;
+    fprintf(f, "{\n  \"schema\": %d,\n", _BENCH_SCHEMA);
+    fprintf(f, "  \"sodium_version\": \"%s\",\n", sodium_version_string());
+    fprintf(f, "  \"host\": {\"cpus\": %ld, \"codec_simd\": %d, "
+               "\"container_aead\": %d},\n",
+            sysconf(_SC_NPROCESSORS_ONLN), codec_simd_level(),
+            container_selected_aead());
+    fprintf(f, "  \"cases\": [");
+    size_t written = 0;
+    for (size_t i = 0; i < _resultCount; ++i) {
+        const _bench_result* r = &_results[i];
+        if (r->failed) continue;
+        const _baseline_entry* e = _baseline_find(r->id);
+        fprintf(f, "%s\n    {\"id\": \"%s\", \"p50_ns\": %llu, "
+                   "\"tolerance\": %.2f}",
+                written++ ? "," : "", r->id, (unsigned long long)r->p50_ns,
+                e != NULL ? e->tolerance : _BENCH_DEFAULT_TOLERANCE);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--quick] [--filter TEXT] [--max-size BYTES]\n"
+            "          [--min-time SECONDS] [--output FILE]\n"
+            "          [--check BASELINE] [--write-baseline FILE]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    _bench_opts o = {
+        .quick = 0,
+        .filter = NULL,
+        .max_size = 256u * 1024 * 1024,
+        .min_time_s = 0.5,
+        .output = NULL,
+        .check = NULL,
+        .write_baseline = NULL,
+    };
+    int max_size_set = 0, min_time_set = 0;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--quick") == 0) {
+            o.quick = 1;
+        } else if (strcmp(a, "--filter") == 0 && v != NULL) {
+            o.filter = v;
+            ++i;
+        } else if (strcmp(a, "--max-size") == 0 && v != NULL) {
+            o.max_size = (size_t)strtoull(v, NULL, 10);
+            max_size_set = 1;
+            ++i;
+        } else if (strcmp(a, "--min-time") == 0 && v != NULL) {
+            o.min_time_s = strtod(v, NULL);
+            min_time_set = 1;
+            ++i;
+        } else if (strcmp(a, "--output") == 0 && v != NULL) {
+            o.output = v;
+            ++i;
+        } else if (strcmp(a, "--check") == 0 && v != NULL) {
+            o.check = v;
+            ++i;
+        } else if (strcmp(a, "--write-baseline") == 0 && v != NULL) {
+            o.write_baseline = v;
+            ++i;
+        } else {
+            _usage(argv[0]);
+            return 2;
+        }
+    }
+    if (o.quick) {
+        if (!max_size_set) o.max_size = 1024 * 1024;
+        if (!min_time_set) o.min_time_s = 0.1;
+    }
+
+    if (o.check != NULL && _load_baseline(o.check) != 0) {
+        fprintf(stderr, "cannot read baseline %s\n", o.check);
+        return 2;
+    }
+    if (sodium_init() < 0) {
+        fprintf(stderr, "sodium_init() failed\n");
+        return 1;
+    }
+    if (o.check != NULL && o.write_baseline == NULL &&
+        !_baseline_host_matches()) {
+        fprintf(stderr, "%s was recorded on a host with different code "
+                        "paths; skipping the check (refresh it with "
+                        "--write-baseline)\n", o.check);
+        return _BENCH_EXIT_SKIP;
+    }
+    randombytes_buf(_key, sizeof _key);
+
+    // 64 B .. 256 MiB in steps of 16x.
+    static const size_t sizes[] = {
+        64, 1024, 16 * 1024, 256 * 1024, 1024 * 1024, 16 * 1024 * 1024,
+        256 * 1024 * 1024,
+    };
+    size_t largest = 0;
+    for (size_t i = 0; i < sizeof sizes / sizeof *sizes; ++i) {
+        if (sizes[i] <= o.max_size) largest = sizes[i];
+    }
+    uint8_t* data = largest ? malloc(largest) : NULL;
+    if (largest && data == NULL) {
+        fprintf(stderr, "cannot allocate %zu byte payload\n", largest);
+        return 1;
+    }
+    if (data != NULL) randombytes_buf(data, largest);
+
+    fprintf(stderr, "payloads\n");
+    for (size_t i = 0; i < sizeof sizes / sizeof *sizes; ++i) {
+        if (sizes[i] > o.max_size) break;
+        if (_bench_payload(&o, data, sizes[i]) != 0) {
+            fprintf(stderr, "  setup failed for %zu bytes\n", sizes[i]);
+        }
+    }
+    free(data);
+
+    fprintf(stderr, "kdf\n");
+    _bench(&o, "hkdf_sha256", 0, _case_hkdf_sha256, NULL);
+    _pwhash_ctx interactive = {crypto_pwhash_OPSLIMIT_INTERACTIVE,
+                               crypto_pwhash_MEMLIMIT_INTERACTIVE};
+    _pwhash_ctx moderate = {crypto_pwhash_OPSLIMIT_MODERATE,
+                            crypto_pwhash_MEMLIMIT_MODERATE};
+    _pwhash_ctx sensitive = {crypto_pwhash_OPSLIMIT_SENSITIVE,
+                             crypto_pwhash_MEMLIMIT_SENSITIVE};
+    _bench(&o, "argon2id_interactive", 0, _case_pwhash_preset, &interactive);
+    _bench(&o, "argon2id_moderate", 0, _case_pwhash_preset, &moderate);
+    if (!o.quick) {
+        _bench(&o, "argon2id_sensitive", 0, _case_pwhash_preset, &sensitive);
+    }
+    // hash_password() with the preset this machine selects at runtime.
+    _bench(&o, "hash_password", 0, _case_hash_password, NULL);
+
+    fprintf(stderr, "integrity\n");
+    _bench(&o, "quick_probe_native", 0, _case_quick_probe, NULL);
+    _bench(&o, "full_probe_native", 0, _case_full_probe, NULL);
+
+    int failed = 0;
+    for (size_t i = 0; i < _resultCount; ++i) failed |= _results[i].failed;
+
+    FILE* out = stdout;
+    if (o.output != NULL && (out = fopen(o.output, "w")) == NULL) {
+        perror(o.output);
+        return 1;
+    }
+    _write_json(out, &o);
+    if (out != stdout) fclose(out);
+
+    if (o.write_baseline != NULL && _write_baseline(o.write_baseline) != 0) {
+        perror(o.write_baseline);
+        return 1;
+    }
+    if (o.check != NULL) {
+        const int regressions = _check_baseline();
+        fprintf(stderr, "%d regression(s) against %s\n", regressions, o.check);
+        return regressions ? 1 : 0;
+    }
+    return failed ? 1 : 0;
+}
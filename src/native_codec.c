@@ -0,0 +1,519 @@
+#include "native_codec.h"
+#include "native_stats.h"
+#include "sodium.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define _CODEC_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    define _CODEC_TARGET(isa) // MSVC emits any intrinsic without flags
+#  else
+#    define _CODEC_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#  define _CODEC_NEON 1
+#  include <arm_neon.h>
+#endif
+
+/* ---------------------------------------------------------------------------
+ *  BASE64 / BASE32
+ *
+ *  These codecs carry keys and decrypted plaintext, so, like libsodium's
+ *  own sodium_bin2base64(), the scalar code maps characters with
+ *  branch-free mask arithmetic instead of lookup tables. The SIMD loops do
+ *  the same per lane and only branch once per block, on whether every lane
+ *  was valid; the first block holding padding or a bad character is left
+ *  to the scalar loop, which also produces the exact error.
+ * -------------------------------------------------------------------------*/
+
+#define _EQ(x, y) ((((0U - ((unsigned)(x) ^ (unsigned)(y))) >> 8) & 0xFF) ^ 0xFF)
+#define _GT(x, y) ((((unsigned)(y) - (unsigned)(x)) >> 8) & 0xFF)
+#define _GE(x, y) (_GT(y, x) ^ 0xFF)
+#define _LT(x, y) _GT(y, x)
+#define _LE(x, y) _GE(y, x)
+
+static char _b64_char(unsigned x) {
+    return (char)((_LT(x, 26) & (x + 'A')) |
+                  (_GE(x, 26) & _LT(x, 52) & (x + ('a' - 26))) |
+                  (_GE(x, 52) & _LT(x, 62) & (x + ('0' - 52))) |
+                  (_EQ(x, 62) & '+') | (_EQ(x, 63) & '/'));
+}
+
+// Returns 0..63, or 0xFF for a character outside both alphabets.
+static unsigned _b64_value(unsigned c) {
+    const unsigned x = (_GE(c, 'A') & _LE(c, 'Z') & (c - 'A')) |
+                       (_GE(c, 'a') & _LE(c, 'z') & (c - ('a' - 26))) |
+                       (_GE(c, '0') & _LE(c, '9') & (c - ('0' - 52))) |
+                       ((_EQ(c, '+') | _EQ(c, '-')) & 62) |
+                       ((_EQ(c, '/') | _EQ(c, '_')) & 63);
+    return x | (_EQ(x, 0) & (_EQ(c, 'A') ^ 0xFF));
+}
+
+static char _b32_char(unsigned x) {
+    return (char)((_LT(x, 26) & (x + 'A')) |
+                  (_GE(x, 26) & (x + ('2' - 26))));
+}
+
+static unsigned _b32_value(unsigned c) {
+    const unsigned x = (_GE(c, 'A') & _LE(c, 'Z') & (c - 'A')) |
+                       (_GE(c, 'a') & _LE(c, 'z') & (c - 'a')) |
+                       (_GE(c, '2') & _LE(c, '7') & (c - ('2' - 26)));
+    return x | (_EQ(x, 0) & ((_EQ(c, 'A') | _EQ(c, 'a')) ^ 0xFF));
+}
+
+// CODEC_SIMD_* once probed, -1 before. Recomputing it is harmless, so a
+// racy first call needs no lock.
+static volatile int _codecLevel = -1;
+
+int codec_simd_level(void) {
+    int level = _codecLevel;
+    if (level >= 0) return level;
+    level = CODEC_SIMD_NONE;
+#if defined(_CODEC_X86)
+    // libsodium's CPU probe also checks that the OS saves YMM state.
+    if (sodium_init() >= 0) {
+        if (sodium_runtime_has_avx2()) level = CODEC_SIMD_AVX2;
+        else if (sodium_runtime_has_ssse3()) level = CODEC_SIMD_SSSE3;
+    }
+#elif defined(_CODEC_NEON)
+    level = CODEC_SIMD_NEON;
+#endif
+    _codecLevel = level;
+    return level;
+}
+
+/* ----------------------------- SIMD kernels ------------------------------
+ *  Encoders return the number of input bytes consumed (a multiple of 3)
+ *  and decoders the number of characters consumed (a multiple of 4); the
+ *  caller finishes the rest with the scalar loop.
+ *
+ *  x86 follows Muła & Lemire ("Faster Base64 Encoding and Decoding using
+ *  AVX2 Instructions"): pshufb spreads 3 bytes over 4 lanes, mulhi/mullo
+ *  isolate the sextets, and a 16-entry pshufb table turns them into ASCII.
+ *  Decoding validates and translates with range compares (which also
+ *  covers the URL-safe alphabet) and packs with pmaddubsw/pmaddwd.
+ * -------------------------------------------------------------------------*/
+
+#if defined(_CODEC_X86)
+
+_CODEC_TARGET("ssse3")
+static __m128i _b64_enc_lanes_sse(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                           4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i idx = _mm_or_si128(t1, t3);
+
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+    __m128i sel = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+    sel = _mm_or_si128(sel, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, sel), idx);
+}
+
+_CODEC_TARGET("ssse3")
+static size_t _b64_encode_ssse3(const uint8_t* in, size_t len, char* out) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 12, out += 16) { // reads 16, uses 12
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        _mm_storeu_si128((__m128i*)out, _b64_enc_lanes_sse(v));
+    }
+    return i;
+}
+
+// Sextet values for 16 characters; clears *ok if any lane is invalid.
+_CODEC_TARGET("ssse3")
+static __m128i _b64_dec_lanes_sse(__m128i v, int* ok) {
+#define _IN_RANGE(lo, hi) _mm_and_si128(                        \
+        _mm_cmpgt_epi8(v, _mm_set1_epi8((char)((lo) - 1))),     \
+        _mm_cmpgt_epi8(_mm_set1_epi8((char)((hi) + 1)), v))
+    const __m128i upper = _IN_RANGE('A', 'Z');
+    const __m128i lower = _IN_RANGE('a', 'z');
+    const __m128i digit = _IN_RANGE('0', '9');
+#undef _IN_RANGE
+    const __m128i plus = _mm_cmpeq_epi8(v, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+    const __m128i dash = _mm_cmpeq_epi8(v, _mm_set1_epi8('-'));
+    const __m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+
+    const __m128i valid = _mm_or_si128(
+        _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)),
+        _mm_or_si128(_mm_or_si128(slash, dash), under));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) *ok = 0;
+
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-65));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(4)));
+    shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(19)));
+    shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(16)));
+    shift = _mm_or_si128(shift, _mm_and_si128(dash, _mm_set1_epi8(17)));
+    shift = _mm_or_si128(shift, _mm_and_si128(under, _mm_set1_epi8(-32)));
+    return _mm_add_epi8(v, shift);
+}
+
+// Packs 16 sextets into 12 bytes at the bottom of the register.
+_CODEC_TARGET("ssse3")
+static __m128i _b64_pack_sse(__m128i s) {
+    const __m128i ab_bc = _mm_maddubs_epi16(s, _mm_set1_epi32(0x01400140));
+    const __m128i abc = _mm_madd_epi16(ab_bc, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(abc, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                               14, 13, 12, -1, -1, -1, -1));
+}
+
+_CODEC_TARGET("ssse3")
+static size_t _b64_decode_ssse3(const char* in, size_t len, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16, out += 12) {
+        int ok = 1;
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        const __m128i s = _b64_dec_lanes_sse(v, &ok);
+        if (!ok) break;
+        const __m128i b = _b64_pack_sse(s);
+        const int tail = _mm_cvtsi128_si32(_mm_srli_si128(b, 8));
+        _mm_storel_epi64((__m128i*)out, b);
+        memcpy(out + 8, &tail, 4);
+    }
+    return i;
+}
+
+_CODEC_TARGET("avx2")
+static size_t _b64_encode_avx2(const uint8_t* in, size_t len, char* out) {
+    const __m256i spread = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i offsets = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    for (; i + 28 <= len; i += 24, out += 32) { // 12 bytes per 128-bit lane
+        const __m128i lo = _mm_loadu_si128((const __m128i*)(in + i));
+        const __m128i hi = _mm_loadu_si128((const __m128i*)(in + i + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_shuffle_epi8(v, spread);
+        const __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i idx = _mm256_or_si256(t1, t3);
+
+        __m256i sel = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+        const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+        sel = _mm256_or_si256(sel, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        const __m256i ascii =
+            _mm256_add_epi8(_mm256_shuffle_epi8(offsets, sel), idx);
+        _mm256_storeu_si256((__m256i*)out, ascii);
+    }
+    return i;
+}
+
+_CODEC_TARGET("avx2")
+static size_t _b64_decode_avx2(const char* in, size_t len, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32, out += 24) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+#define _IN_RANGE(lo, hi) _mm256_and_si256(                        \
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8((char)((lo) - 1))),  \
+        _mm256_cmpgt_epi8(_mm256_set1_epi8((char)((hi) + 1)), v))
+        const __m256i upper = _IN_RANGE('A', 'Z');
+        const __m256i lower = _IN_RANGE('a', 'z');
+        const __m256i digit = _IN_RANGE('0', '9');
+#undef _IN_RANGE
+        const __m256i plus = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('+'));
+        const __m256i slash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
+        const __m256i dash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-'));
+        const __m256i under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+
+        const __m256i valid = _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(upper, lower),
+                            _mm256_or_si256(digit, plus)),
+            _mm256_or_si256(_mm256_or_si256(slash, dash), under));
+        if (_mm256_movemask_epi8(valid) != -1) break;
+
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(19)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(dash, _mm256_set1_epi8(17)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(under, _mm256_set1_epi8(-32)));
+        const __m256i s = _mm256_add_epi8(v, shift);
+
+        const __m256i ab_bc =
+            _mm256_maddubs_epi16(s, _mm256_set1_epi32(0x01400140));
+        __m256i b = _mm256_madd_epi16(ab_bc, _mm256_set1_epi32(0x00011000));
+        b = _mm256_shuffle_epi8(b, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // 12 bytes per lane -> 24 contiguous bytes
+        b = _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(b));
+        _mm_storel_epi64((__m128i*)(out + 16), _mm256_extracti128_si256(b, 1));
+    }
+    return i;
+}
+
+#elif defined(_CODEC_NEON)
+
+// NEON has interleaving loads/stores (vld3/vst4), so sextets are split with
+// plain shifts and mapped to ASCII by adding a per-range offset.
+static uint8x16_t _b64_ascii_neon(uint8x16_t x) {
+    uint8x16_t shift = vdupq_n_u8('A');
+    shift = vaddq_u8(shift, vandq_u8(vcgtq_u8(x, vdupq_n_u8(25)), vdupq_n_u8(6)));
+    shift = vsubq_u8(shift, vandq_u8(vcgtq_u8(x, vdupq_n_u8(51)), vdupq_n_u8(75)));
+    shift = vsubq_u8(shift, vandq_u8(vcgtq_u8(x, vdupq_n_u8(61)), vdupq_n_u8(15)));
+    shift = vaddq_u8(shift, vandq_u8(vcgtq_u8(x, vdupq_n_u8(62)), vdupq_n_u8(3)));
+    return vaddq_u8(x, shift);
+}
+
+static size_t _b64_encode_neon(const uint8_t* in, size_t len, char* out) {
+    const uint8x16_t m = vdupq_n_u8(0x3f);
+    size_t i = 0;
+    for (; i + 48 <= len; i += 48, out += 64) {
+        const uint8x16x3_t src = vld3q_u8(in + i);
+        uint8x16x4_t dst;
+        dst.val[0] = vshrq_n_u8(src.val[0], 2);
+        dst.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(src.val[0], 4),
+                                       vshrq_n_u8(src.val[1], 4)), m);
+        dst.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(src.val[1], 2),
+                                       vshrq_n_u8(src.val[2], 6)), m);
+        dst.val[3] = vandq_u8(src.val[2], m);
+        for (int k = 0; k < 4; ++k) dst.val[k] = _b64_ascii_neon(dst.val[k]);
+        vst4q_u8((uint8_t*)out, dst);
+    }
+    return i;
+}
+
+static uint8x16_t _b64_sextets_neon(uint8x16_t v, uint8x16_t* bad) {
+#define _IN_RANGE(lo, hi) \
+        vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi)))
+    const uint8x16_t upper = _IN_RANGE('A', 'Z');
+    const uint8x16_t lower = _IN_RANGE('a', 'z');
+    const uint8x16_t digit = _IN_RANGE('0', '9');
+#undef _IN_RANGE
+    const uint8x16_t plus = vceqq_u8(v, vdupq_n_u8('+'));
+    const uint8x16_t slash = vceqq_u8(v, vdupq_n_u8('/'));
+    const uint8x16_t dash = vceqq_u8(v, vdupq_n_u8('-'));
+    const uint8x16_t under = vceqq_u8(v, vdupq_n_u8('_'));
+
+    const uint8x16_t valid = vorrq_u8(
+        vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, plus)),
+        vorrq_u8(vorrq_u8(slash, dash), under));
+    *bad = vorrq_u8(*bad, vmvnq_u8(valid));
+
+    uint8x16_t shift = vandq_u8(upper, vdupq_n_u8((uint8_t)-65));
+    shift = vorrq_u8(shift, vandq_u8(lower, vdupq_n_u8((uint8_t)-71)));
+    shift = vorrq_u8(shift, vandq_u8(digit, vdupq_n_u8(4)));
+    shift = vorrq_u8(shift, vandq_u8(plus, vdupq_n_u8(19)));
+    shift = vorrq_u8(shift, vandq_u8(slash, vdupq_n_u8(16)));
+    shift = vorrq_u8(shift, vandq_u8(dash, vdupq_n_u8(17)));
+    shift = vorrq_u8(shift, vandq_u8(under, vdupq_n_u8((uint8_t)-32)));
+    return vaddq_u8(v, shift);
+}
+
+static size_t _b64_decode_neon(const char* in, size_t len, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64, out += 48) {
+        uint8x16x4_t src = vld4q_u8((const uint8_t*)in + i);
+        uint8x16_t bad = vdupq_n_u8(0);
+        for (int k = 0; k < 4; ++k) {
+            src.val[k] = _b64_sextets_neon(src.val[k], &bad);
+        }
+        const uint64x2_t b64 = vreinterpretq_u64_u8(bad);
+        if ((vgetq_lane_u64(b64, 0) | vgetq_lane_u64(b64, 1)) != 0) break;
+
+        uint8x16x3_t dst;
+        dst.val[0] = vorrq_u8(vshlq_n_u8(src.val[0], 2), vshrq_n_u8(src.val[1], 4));
+        dst.val[1] = vorrq_u8(vshlq_n_u8(src.val[1], 4), vshrq_n_u8(src.val[2], 2));
+        dst.val[2] = vorrq_u8(vshlq_n_u8(src.val[2], 6), src.val[3]);
+        vst3q_u8(out, dst);
+    }
+    return i;
+}
+
+#endif
+
+/* ------------------------------- Base64 ---------------------------------- */
+
+size_t base64_encoded_len(size_t bin_len) {
+    return (bin_len + 2) / 3 * 4;
+}
+
+size_t base64_decoded_max_len(size_t b64_len) {
+    return b64_len / 4 * 3 + (b64_len % 4) * 3 / 4;
+}
+
+int64_t base64_encode(const uint8_t* in, size_t in_len,
+                      char* out, size_t out_cap) {
+    STATS_SCOPE(STATS_FN_BASE64_ENCODE, in_len);
+    if (in == NULL && in_len > 0) return -1;
+    if (in_len > SIZE_MAX / 4 - 2) return -1;
+    const size_t need = base64_encoded_len(in_len);
+    if (out == NULL || out_cap < need) return -1;
+
+    size_t i = 0;
+    switch (codec_simd_level()) {
+#if defined(_CODEC_X86)
+    case CODEC_SIMD_AVX2: i = _b64_encode_avx2(in, in_len, out); break;
+    case CODEC_SIMD_SSSE3: i = _b64_encode_ssse3(in, in_len, out); break;
+#elif defined(_CODEC_NEON)
+    case CODEC_SIMD_NEON: i = _b64_encode_neon(in, in_len, out); break;
+#endif
+    default: break;
+    }
+
+    char* o = out + i / 3 * 4;
+    for (; i + 3 <= in_len; i += 3, o += 4) {
+        const unsigned w = ((unsigned)in[i] << 16) | ((unsigned)in[i + 1] << 8) |
+                           in[i + 2];
+        o[0] = _b64_char(w >> 18);
+        o[1] = _b64_char((w >> 12) & 0x3f);
+        o[2] = _b64_char((w >> 6) & 0x3f);
+        o[3] = _b64_char(w & 0x3f);
+    }
+    if (i < in_len) {
+        const unsigned w = ((unsigned)in[i] << 16) |
+                           (i + 1 < in_len ? (unsigned)in[i + 1] << 8 : 0);
+        o[0] = _b64_char(w >> 18);
+        o[1] = _b64_char((w >> 12) & 0x3f);
+        o[2] = i + 1 < in_len ? _b64_char((w >> 6) & 0x3f) : '=';
+        o[3] = '=';
+    }
+    return (int64_t)need;
+}
+
+int64_t base64_decode(const char* in, size_t in_len,
+                      uint8_t* out, size_t out_cap) {
+    STATS_SCOPE(STATS_FN_BASE64_DECODE, in_len);
+    if (in == NULL && in_len > 0) return -1;
+
+    // Strip up to two '=' and require the padded form to be complete.
+    size_t n = in_len;
+    if (n > 0 && in[n - 1] == '=') {
+        if (n % 4 != 0) return -1;
+        --n;
+        if (in[n - 1] == '=') --n;
+    }
+    if (n % 4 == 1) return -1;
+
+    const size_t need = base64_decoded_max_len(n);
+    if (need > 0 && (out == NULL || out_cap < need)) return -1;
+
+    size_t i = 0;
+    switch (codec_simd_level()) {
+#if defined(_CODEC_X86)
+    case CODEC_SIMD_AVX2: i = _b64_decode_avx2(in, n, out); break;
+    case CODEC_SIMD_SSSE3: i = _b64_decode_ssse3(in, n, out); break;
+#elif defined(_CODEC_NEON)
+    case CODEC_SIMD_NEON: i = _b64_decode_neon(in, n, out); break;
+#endif
+    default: break;
+    }
+
+    uint8_t* o = out + i / 4 * 3;
+    unsigned bad = 0;
+    for (; i + 4 <= n; i += 4, o += 3) {
+        const unsigned a = _b64_value((uint8_t)in[i]);
+        const unsigned b = _b64_value((uint8_t)in[i + 1]);
+        const unsigned c = _b64_value((uint8_t)in[i + 2]);
+        const unsigned d = _b64_value((uint8_t)in[i + 3]);
+        bad |= a | b | c | d;
+        const unsigned w = (a << 18) | (b << 12) | (c << 6) | d;
+        o[0] = (uint8_t)(w >> 16);
+        o[1] = (uint8_t)(w >> 8);
+        o[2] = (uint8_t)w;
+    }
+    if (i < n) { // 2 or 3 characters left
+        const unsigned a = _b64_value((uint8_t)in[i]);
+        const unsigned b = _b64_value((uint8_t)in[i + 1]);
+        const unsigned c = i + 2 < n ? _b64_value((uint8_t)in[i + 2]) : 0;
+        bad |= a | b | c;
+        const unsigned w = (a << 18) | (b << 12) | (c << 6);
+        *o++ = (uint8_t)(w >> 16);
+        if (i + 2 < n) *o++ = (uint8_t)(w >> 8);
+    }
+    // Valid values are < 64, so bit 7 is only set by an invalid character.
+    if (bad & 0x80) {
+        if (need > 0) sodium_memzero(out, need);
+        return -1;
+    }
+    return (int64_t)need;
+}
+
+/* ------------------------------- Base32 ---------------------------------- */
+
+size_t base32_encoded_len(size_t bin_len, int pad) {
+    return pad ? (bin_len + 4) / 5 * 8 : (bin_len * 8 + 4) / 5;
+}
+
+size_t base32_decoded_max_len(size_t b32_len) {
+    return b32_len * 5 / 8;
+}
+
+int64_t base32_encode(const uint8_t* in, size_t in_len,
+                      char* out, size_t out_cap, int pad) {
+    if (in == NULL && in_len > 0) return -1;
+    if (in_len > SIZE_MAX / 8 - 4) return -1;
+    const size_t need = base32_encoded_len(in_len, pad);
+    if (out == NULL || out_cap < need) return -1;
+
+    size_t i = 0;
+    char* o = out;
+    for (; i + 5 <= in_len; i += 5, o += 8) { // 40 bits -> 8 characters
+        uint64_t w = 0;
+        for (int k = 0; k < 5; ++k) w = (w << 8) | in[i + k];
+        for (int k = 7; k >= 0; --k, w >>= 5) o[k] = _b32_char((unsigned)w & 31);
+    }
+    if (i < in_len) {
+        const size_t rest = in_len - i;
+        const size_t chars = (rest * 8 + 4) / 5;
+        uint64_t w = 0;
+        for (size_t k = 0; k < 5; ++k) w = (w << 8) | (k < rest ? in[i + k] : 0);
+        for (size_t k = 0; k < chars; ++k) {
+            o[k] = _b32_char((unsigned)(w >> (35 - 5 * k)) & 31);
+        }
+        o += chars;
+        if (pad) {
+            for (size_t k = chars; k < 8; ++k) *o++ = '=';
+        }
+    }
+    return (int64_t)need;
+}
+
+int64_t base32_decode(const char* in, size_t in_len,
+                      uint8_t* out, size_t out_cap) {
+    if (in == NULL && in_len > 0) return -1;
+
+    uint64_t buffer = 0;
+    int bits = 0;
+    size_t len = 0;
+    for (size_t i = 0; i < in_len; ++i) {
+        const char ch = in[i];
+        if (ch == '=' || ch == ' ' || ch == '-') continue;
+        const unsigned v = _b32_value((uint8_t)ch);
+        if (v & 0x80) goto fail;
+
+        buffer = (buffer << 5) | v;
+        bits += 5;
+        if (bits >= 8) {
+            if (out == NULL || len == out_cap) goto fail;
+            bits -= 8;
+            out[len++] = (uint8_t)(buffer >> bits);
+        }
+    }
+    return (int64_t)len;
+
+fail:
+    if (len > 0) sodium_memzero(out, len);
+    return -1;
+}
@@ -0,0 +1,68 @@
+// native_codec.h
+#ifndef NATIVE_CODEC_H
+#define NATIVE_CODEC_H
+#include <stddef.h>
+#include <stdint.h>
+
+// RFC 4648 Base64 / Base32 codecs working on caller-provided buffers.
+//
+// Base64 uses SIMD fast paths (AVX2 or SSSE3 on x86, picked at runtime;
+// NEON on ARM) for the bulk of the input and a scalar loop for the tail.
+// Base32 is only used for short secrets and stays scalar, but works on
+// whole 5-byte groups instead of bit by bit.
+//
+// Encoders do not write a NUL terminator. All functions return the number
+// of bytes written, or -1 when the output buffer is too small or the input
+// is malformed.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fast path in use; values returned by codec_simd_level().
+#define CODEC_SIMD_NONE  0
+#define CODEC_SIMD_SSSE3 1
+#define CODEC_SIMD_AVX2  2
+#define CODEC_SIMD_NEON  3
+
+int codec_simd_level(void);
+
+// Length of the padded Base64 encoding of [bin_len] bytes.
+size_t base64_encoded_len(size_t bin_len);
+
+// Upper bound for the decoded size of [b64_len] characters.
+size_t base64_decoded_max_len(size_t b64_len);
+
+// Encodes with the standard alphabet and '=' padding.
+int64_t base64_encode(const uint8_t* in, size_t in_len,
+                      char* out, size_t out_cap);
+
+// Decodes the standard or URL-safe alphabet, with or without '=' padding.
+// '+'/'-' and '/'/'_' are accepted anywhere, so input mixing the two
+// alphabets also decodes. Whitespace is rejected, matching dart:convert.
+int64_t base64_decode(const char* in, size_t in_len,
+                      uint8_t* out, size_t out_cap);
+
+// Length of the Base32 encoding of [bin_len] bytes, with or without '='
+// padding.
+size_t base32_encoded_len(size_t bin_len, int pad);
+
+// Upper bound for the decoded size of [b32_len] characters.
+size_t base32_decoded_max_len(size_t b32_len);
+
+// Encodes with the upper-case RFC 4648 alphabet. [pad] appends '=' up to a
+// multiple of 8 characters (authenticator URIs usually omit it).
+int64_t base32_encode(const uint8_t* in, size_t in_len,
+                      char* out, size_t out_cap, int pad);
+
+// Decodes case-insensitively. '=', spaces and '-' are skipped so grouped
+// secrets as typed by users ("JBSW Y3DP ...") are accepted; trailing bits
+// that do not fill a byte are dropped.
+int64_t base32_decode(const char* in, size_t in_len,
+                      uint8_t* out, size_t out_cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_CODEC_H
@@ -1,7 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <time.h>
 #include "native_crypto.h" // Our own header file.
+#include "native_codec.h"
+#include "native_rng.h"
+#include "native_secmem.h"
+#include "native_stats.h"
 #include "sodium.h" // The main header from the libsodium library.
 #if defined(__linux__) || defined(__ANDROID__)
 #  include <sys/sysinfo.h>
@@ -58,6 +64,27 @@ static size_t _determine_memlimit() {
     return crypto_pwhash_MEMLIMIT_MODERATE;
 }
 
+// RAM does not change while we run, so the parameters are picked once (by
+// native_crypto_warmup() if it got there first) instead of on every unlock.
+static pthread_once_t _kdfOnce = PTHREAD_ONCE_INIT;
+static uint64_t _kdfOpslimit;
+static size_t _kdfMemlimit;
+
+static void _select_kdf_params(void) {
+    _kdfOpslimit = _determine_opslimit();
+    _kdfMemlimit = _determine_memlimit();
+}
+
+static uint64_t _kdf_opslimit(void) {
+    pthread_once(&_kdfOnce, _select_kdf_params);
+    return _kdfOpslimit;
+}
+
+static size_t _kdf_memlimit(void) {
+    pthread_once(&_kdfOnce, _select_kdf_params);
+    return _kdfMemlimit;
+}
+
 // This is the implementation of the function we declared in the header.
 const char* get_libsodium_version_string() {
     // It's mandatory to initialize libsodium before using any other function.
@@ -74,6 +101,7 @@ const char* get_libsodium_version_string() {
 // Hash password and return malloc'ed hash string (Argon2id). Caller must free
 // using free_string(). Returns NULL on failure.
 const char* hash_password(const char* password) {
+    STATS_SCOPE(STATS_FN_HASH_PASSWORD, 0);
     if (sodium_init() < 0) return NULL;
 
     char* out = malloc(crypto_pwhash_STRBYTES);
@@ -82,8 +110,8 @@ const char* hash_password(const char* password) {
     if (crypto_pwhash_str(out,
                           password,
                           strlen(password),
-                          _determine_opslimit(),
-                          _determine_memlimit()) != 0) {
+                          _kdf_opslimit(),
+                          _kdf_memlimit()) != 0) {
         free(out);
         return NULL;
     }
@@ -91,100 +119,130 @@ const char* hash_password(const char* password) {
 }
 
 bool verify_password(const char* hash, const char* password) {
+    STATS_SCOPE(STATS_FN_VERIFY_PASSWORD, 0);
     if (sodium_init() < 0) return false;
     return crypto_pwhash_str_verify(hash, password, strlen(password)) == 0;
 }
 
+// Strings returned by this library may carry key material (Base64 keys,
+// plaintext), so they are wiped on the way out whichever allocator they
+// came from.
 void free_string(char* str) {
     if (str != NULL) {
-        free(str);
+        secmem_free(str, strlen(str) + 1);
     }
 }
 
-// Helper: base64 encode using libsodium, returns malloc'd string
+// Helper: base64 encode (native_codec), returns a secmem string for
+// free_string()
 static char* _bin_to_b64(const unsigned char* bin, size_t bin_len) {
-    size_t b64_len = sodium_base64_ENCODED_LEN(bin_len, sodium_base64_VARIANT_ORIGINAL);
-    char* b64 = malloc(b64_len);
+    size_t b64_len = base64_encoded_len(bin_len);
+    char* b64 = secmem_alloc(b64_len + 1);
     if (b64 == NULL) return NULL;
-    sodium_bin2base64(b64, b64_len, bin, bin_len, sodium_base64_VARIANT_ORIGINAL);
+    if (base64_encode(bin, bin_len, b64, b64_len) < 0) {
+        secmem_free(b64, b64_len + 1);
+        return NULL;
+    }
+    b64[b64_len] = '\0';
     return b64;
 }
 
-// Helper: decode base64 -> bin (malloc)
-static unsigned char* _b64_to_bin(const char* b64, size_t* out_len) {
-    size_t max_len = strlen(b64) * 3 / 4 + 1;
-    unsigned char* bin = malloc(max_len);
+// Helper: decode base64 -> bin (secmem); *alloc_len receives the size to
+// pass to secmem_free()
+static unsigned char* _b64_to_bin(const char* b64, size_t* out_len,
+                                  size_t* alloc_len) {
+    size_t b64_len = strlen(b64);
+    size_t max_len = base64_decoded_max_len(b64_len) + 1;
+    unsigned char* bin = secmem_alloc(max_len);
     if (bin == NULL) return NULL;
-    if (sodium_base642bin(bin, max_len, b64, strlen(b64), NULL, out_len, NULL,
-                          sodium_base64_VARIANT_ORIGINAL) != 0) {
-        free(bin);
+    int64_t n = base64_decode(b64, b64_len, bin, max_len);
+    if (n < 0) {
+        secmem_free(bin, max_len);
         return NULL;
     }
+    *out_len = (size_t)n;
+    *alloc_len = max_len;
     return bin;
 }
 
 // Encrypt bytes with XChaCha20-Poly1305; returns base64 encoded (nonce+cipher)
 char* encrypt_bytes(const uint8_t* data, size_t len,
                     const uint8_t* key, size_t key_len) {
+    return encrypt_bytes_ad(data, len, key, key_len, NULL, 0);
+}
+
+// Decrypt base64 blob back to plaintext; returns base64 of plaintext
+char* decrypt_bytes(const char* enc_b64,
+                    const uint8_t* key, size_t key_len) {
+    return decrypt_bytes_ad(enc_b64, key, key_len, NULL, 0);
+}
+
+char* encrypt_bytes_ad(const uint8_t* data, size_t len,
+                       const uint8_t* key, size_t key_len,
+                       const uint8_t* ad, size_t ad_len) {
+    STATS_SCOPE(STATS_FN_ENCRYPT_BYTES, len);
     if (key_len != crypto_aead_xchacha20poly1305_ietf_KEYBYTES) {
         return NULL;
     }
+    if (ad == NULL && ad_len > 0) return NULL;
 
     if (sodium_init() < 0) return NULL;
 
     // Allocate buffers
     unsigned char nonce[crypto_aead_xchacha20poly1305_ietf_NPUBBYTES];
-    randombytes_buf(nonce, sizeof nonce);
+    if (rng_fill(nonce, sizeof nonce) != 0) return NULL;
 
     unsigned long long cipher_len = len + crypto_aead_xchacha20poly1305_ietf_ABYTES;
-    unsigned char* cipher = malloc(cipher_len);
+    unsigned char* cipher = secmem_alloc(cipher_len);
     if (cipher == NULL) return NULL;
 
     if (crypto_aead_xchacha20poly1305_ietf_encrypt(
             cipher, &cipher_len,
             data, len,
-            NULL, 0, // no additional data
+            ad, ad_len,
             NULL,
             nonce, key) != 0) {
-        free(cipher);
+        secmem_free(cipher, cipher_len);
         return NULL;
     }
 
     size_t total_len = sizeof nonce + cipher_len;
-    unsigned char* combined = malloc(total_len);
+    unsigned char* combined = secmem_alloc(total_len);
     if (combined == NULL) {
-        free(cipher);
+        secmem_free(cipher, cipher_len);
         return NULL;
     }
     memcpy(combined, nonce, sizeof nonce);
     memcpy(combined + sizeof nonce, cipher, cipher_len);
 
-    free(cipher);
+    secmem_free(cipher, cipher_len);
 
     char* b64 = _bin_to_b64(combined, total_len);
     sodium_memzero((void*)key, key_len);
-    sodium_memzero(combined, total_len);
-    free(combined);
+    secmem_free(combined, total_len);
 
     return b64; // may be NULL if encoding failed
 }
 
-// Decrypt base64 blob back to plaintext; returns base64 of plaintext
-char* decrypt_bytes(const char* enc_b64,
-                    const uint8_t* key, size_t key_len) {
+char* decrypt_bytes_ad(const char* enc_b64,
+                       const uint8_t* key, size_t key_len,
+                       const uint8_t* ad, size_t ad_len) {
+    STATS_SCOPE(STATS_FN_DECRYPT_BYTES, 0);
     if (key_len != crypto_aead_xchacha20poly1305_ietf_KEYBYTES) {
         return NULL;
     }
+    if (ad == NULL && ad_len > 0) return NULL;
 
     if (sodium_init() < 0) return NULL;
 
-    size_t enc_len;
-    unsigned char* enc_bin = _b64_to_bin(enc_b64, &enc_len);
+    size_t enc_len, enc_cap;
+    unsigned char* enc_bin = _b64_to_bin(enc_b64, &enc_len, &enc_cap);
     if (enc_bin == NULL) return NULL;
+    STATS_BYTES(enc_len);
 
     if (enc_len < crypto_aead_xchacha20poly1305_ietf_NPUBBYTES +
                  crypto_aead_xchacha20poly1305_ietf_ABYTES) {
-        free(enc_bin);
+        secmem_free(enc_bin, enc_cap);
         return NULL;
     }
 
@@ -194,9 +252,9 @@ char* decrypt_bytes(const char* enc_b64,
     unsigned char* cipher = enc_bin + sizeof nonce;
     unsigned long long cipher_len = enc_len - sizeof nonce;
 
-    unsigned char* plain = malloc(cipher_len); // decrypt len <= cipher_len
+    unsigned char* plain = secmem_alloc(cipher_len); // decrypt len <= cipher_len
     if (plain == NULL) {
-        free(enc_bin);
+        secmem_free(enc_bin, enc_cap);
         return NULL;
     }
 
@@ -205,21 +263,19 @@ char* decrypt_bytes(const char* enc_b64,
             plain, &plain_len,
             NULL,
             cipher, cipher_len,
-            NULL, 0,
+            ad, ad_len,
             nonce, key) != 0) {
         // decryption failed
-        sodium_memzero(plain, cipher_len);
-        free(plain);
-        free(enc_bin);
+        secmem_free(plain, cipher_len);
+        secmem_free(enc_bin, enc_cap);
         return NULL;
     }
 
     char* b64_plain = _bin_to_b64(plain, plain_len);
 
     sodium_memzero((void*)key, key_len);
-    sodium_memzero(plain, plain_len);
-    free(plain);
-    free(enc_bin);
+    secmem_free(plain, cipher_len);
+    secmem_free(enc_bin, enc_cap);
 
     return b64_plain; // may be NULL if encoding failed
 }
@@ -227,10 +283,10 @@ char* decrypt_bytes(const char* enc_b64,
 // === Added FFI helper implementations ===
 
 int random_bytes(uint8_t* buf, size_t len) {
+    STATS_SCOPE(STATS_FN_RANDOM_BYTES, len);
     if (sodium_init() < 0) return -1;
     if (buf == NULL || len == 0) return -1;
-    randombytes_buf(buf, len);
-    return 0;
+    return rng_fill(buf, len);
 }
 
 int secure_memzero(void* ptr, size_t len) {
@@ -243,6 +299,7 @@ int hkdf_sha256(const uint8_t* ikm, size_t ikm_len,
                 const uint8_t* salt, size_t salt_len,
                 const uint8_t* info, size_t info_len,
                 uint8_t* okm, size_t okm_len) {
+    STATS_SCOPE(STATS_FN_HKDF_SHA256, okm_len);
     if (sodium_init() < 0) return -1;
     if (okm_len == 0 || okm == NULL) return -1;
 
@@ -294,13 +351,14 @@ int hkdf_sha256(const uint8_t* ikm, size_t ikm_len,
 char* derive_session_key_b64(const uint8_t* master_key, size_t master_len,
                              const uint8_t* ephemeral_key, size_t eph_len,
                              const uint8_t* salt, size_t salt_len) {
+    STATS_SCOPE(STATS_FN_DERIVE_SESSION_KEY, 0);
     if (master_key == NULL || master_len == 0 || eph_len == 0) return NULL;
 
     unsigned char ikm[64];
     size_t ikm_len = 0;
     if (master_len + eph_len > sizeof(ikm)) {
         // Fallback: allocate
-        unsigned char* dyn = malloc(master_len + eph_len);
+        unsigned char* dyn = secmem_alloc(master_len + eph_len);
         if (!dyn) return NULL;
         memcpy(dyn, master_key, master_len);
         memcpy(dyn + master_len, ephemeral_key, eph_len);
@@ -308,10 +366,10 @@ char* derive_session_key_b64(const uint8_t* master_key, size_t master_len,
         // Derive key
         unsigned char out[32];
         if (hkdf_sha256(dyn, ikm_len, salt, salt_len, NULL, 0, out, sizeof(out)) != 0) {
-            free(dyn);
+            secmem_free(dyn, ikm_len);
             return NULL;
         }
-        free(dyn);
+        secmem_free(dyn, ikm_len);
         char* b64 = _bin_to_b64(out, sizeof(out));
         sodium_memzero(out, sizeof out);
         return b64;
@@ -331,13 +389,12 @@ char* derive_session_key_b64(const uint8_t* master_key, size_t master_len,
 }
 
 char* random_bytes_b64(size_t len) {
+    STATS_SCOPE(STATS_FN_RANDOM_BYTES, len);
     if (sodium_init() < 0) return NULL;
-    unsigned char* buf = malloc(len);
+    unsigned char* buf = secmem_alloc(len);
     if (!buf) return NULL;
-    randombytes_buf(buf, len);
-    char* b64 = _bin_to_b64(buf, len);
-    sodium_memzero(buf, len);
-    free(buf);
+    char* b64 = rng_fill(buf, len) == 0 ? _bin_to_b64(buf, len) : NULL;
+    secmem_free(buf, len);
     return b64;
 }
 
@@ -345,28 +402,999 @@ char* random_bytes_b64(size_t len) {
 char* pbkdf2_sha256_b64(const char* password,
                         const uint8_t* salt, size_t salt_len,
                         size_t dk_len) {
+    STATS_SCOPE(STATS_FN_PBKDF2_SHA256, dk_len);
     if (password == NULL || salt == NULL || dk_len == 0) return NULL;
     if (sodium_init() < 0) return NULL;
 
-    unsigned char* dk = malloc(dk_len);
+    unsigned char* dk = secmem_alloc(dk_len);
     if (!dk) return NULL;
 
     // Use the same (moderate / sensitive) limits as the primary Argon2id
     // password hashing path so that long-term secrets receive equal
     // protection.  The exact values are selected at compile-time via
     // NH_OPSLIMIT / NH_MEMLIMIT macros (see top of file).
-    const uint64_t ops = _determine_opslimit();
-    const size_t mem  = _determine_memlimit();
+    const uint64_t ops = _kdf_opslimit();
+    const size_t mem  = _kdf_memlimit();
     if (crypto_pwhash(dk, dk_len,
                       password, strlen(password),
                       salt, ops, mem,
                       crypto_pwhash_alg_default()) != 0) {
-        free(dk);
+        secmem_free(dk, dk_len);
         return NULL;
     }
 
     char* b64 = _bin_to_b64(dk, dk_len);
-    sodium_memzero(dk, dk_len);
-    free(dk);
+    secmem_free(dk, dk_len);
     return b64;
-} 
\ No newline at end of file
+}
+
+// === Native hashing (SHA-256 / BLAKE2b) ===
+
+#define _HASH_FILE_CHUNK (64 * 1024)
+
+struct hash_ctx {
+    int alg;
+    size_t digest_len;
+    void* raw; // unaligned allocation backing this struct
+    union {
+        crypto_hash_sha256_state sha256;
+        crypto_generichash_blake2b_state blake2b; // needs 64-byte alignment
+    } st;
+};
+
+hash_ctx* hash_ctx_new(int alg, size_t digest_len) {
+    if (sodium_init() < 0) return NULL;
+
+    if (alg == HASH_ALG_SHA256) {
+        digest_len = crypto_hash_sha256_BYTES;
+    } else if (alg == HASH_ALG_BLAKE2B) {
+        if (digest_len == 0) digest_len = crypto_generichash_blake2b_BYTES;
+        if (digest_len < crypto_generichash_blake2b_BYTES_MIN ||
+            digest_len > crypto_generichash_blake2b_BYTES_MAX) {
+            return NULL;
+        }
+    } else {
+        return NULL;
+    }
+
+    // malloc() only guarantees max_align_t alignment, so over-allocate and
+    // align by hand for the BLAKE2b state.
+    void* raw = malloc(sizeof(hash_ctx) + 63);
+    if (raw == NULL) return NULL;
+    hash_ctx* ctx = (hash_ctx*)(((uintptr_t)raw + 63) & ~(uintptr_t)63);
+    ctx->alg = alg;
+    ctx->digest_len = digest_len;
+    ctx->raw = raw;
+
+    int rc = (alg == HASH_ALG_SHA256)
+        ? crypto_hash_sha256_init(&ctx->st.sha256)
+        : crypto_generichash_blake2b_init(&ctx->st.blake2b, NULL, 0, digest_len);
+    if (rc != 0) {
+        free(raw);
+        return NULL;
+    }
+    return ctx;
+}
+
+int hash_ctx_update(hash_ctx* ctx, const uint8_t* data, size_t len) {
+    if (ctx == NULL || (data == NULL && len > 0)) return -1;
+    if (len == 0) return 0;
+    if (ctx->alg == HASH_ALG_SHA256) {
+        return crypto_hash_sha256_update(&ctx->st.sha256, data, len);
+    }
+    return crypto_generichash_blake2b_update(&ctx->st.blake2b, data, len);
+}
+
+int hash_ctx_final(hash_ctx* ctx, uint8_t* out, size_t out_len) {
+    if (ctx == NULL || out == NULL || out_len < ctx->digest_len) return -1;
+    int rc = (ctx->alg == HASH_ALG_SHA256)
+        ? crypto_hash_sha256_final(&ctx->st.sha256, out)
+        : crypto_generichash_blake2b_final(&ctx->st.blake2b, out, ctx->digest_len);
+    return rc == 0 ? (int)ctx->digest_len : -1;
+}
+
+void hash_ctx_free(hash_ctx* ctx) {
+    if (ctx == NULL) return;
+    void* raw = ctx->raw;
+    sodium_memzero(ctx, sizeof *ctx);
+    free(raw);
+}
+
+int hash_bytes(int alg, const uint8_t* data, size_t len,
+               uint8_t* out, size_t out_len) {
+    STATS_SCOPE(STATS_FN_HASH_BYTES, len);
+    hash_ctx* ctx = hash_ctx_new(alg, alg == HASH_ALG_SHA256 ? 0 : out_len);
+    if (ctx == NULL) return -1;
+    int rc = hash_ctx_update(ctx, data, len);
+    if (rc == 0) rc = hash_ctx_final(ctx, out, out_len);
+    hash_ctx_free(ctx);
+    return rc;
+}
+
+int hash_file(int alg, const char* path, uint8_t* out, size_t out_len) {
+    STATS_SCOPE(STATS_FN_HASH_FILE, 0);
+    if (path == NULL) return -1;
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return -1;
+
+    unsigned char* buf = secmem_alloc(_HASH_FILE_CHUNK);
+    hash_ctx* ctx = hash_ctx_new(alg, alg == HASH_ALG_SHA256 ? 0 : out_len);
+    if (buf == NULL || ctx == NULL) {
+        secmem_free(buf, _HASH_FILE_CHUNK);
+        hash_ctx_free(ctx);
+        fclose(f);
+        return -1;
+    }
+
+    int rc = 0;
+    size_t n;
+    while ((n = fread(buf, 1, _HASH_FILE_CHUNK, f)) > 0) {
+        if (hash_ctx_update(ctx, buf, n) != 0) {
+            rc = -1;
+            break;
+        }
+        STATS_ADD_BYTES(n);
+    }
+    if (rc == 0 && ferror(f)) rc = -1;
+    if (rc == 0) rc = hash_ctx_final(ctx, out, out_len);
+
+    secmem_free(buf, _HASH_FILE_CHUNK);
+    hash_ctx_free(ctx);
+    fclose(f);
+    return rc;
+}
+
+// === Fused encrypt-and-hash container (single pass) ===
+
+#define _CONTAINER_MAX_ABYTES crypto_secretstream_xchacha20poly1305_ABYTES // 17
+#define _CONTAINER_MAX_CHUNK (16 * 1024 * 1024)
+#define _CONTAINER_SALT_BYTES 24 // header slot after the 16-byte prefix
+
+// CONTAINER_AEAD_AUTO unless overridden via container_set_aead().
+static volatile int _containerAead = CONTAINER_AEAD_AUTO;
+
+typedef struct {
+    int aead; // CONTAINER_AEAD_XCHACHA20 or CONTAINER_AEAD_AES256GCM
+    size_t abytes; // per-record authentication overhead
+    union {
+        crypto_secretstream_xchacha20poly1305_state ss;
+        crypto_aead_aes256gcm_state gcm; // expanded per-container subkey
+    } st;
+    uint64_t counter; // AES-GCM record counter (part of the nonce)
+    hash_ctx* hash; // NULL when the caller did not ask for a digest
+    unsigned char* ad; // prefix || caller AD, used for the first record
+    size_t ad_len;
+    uint32_t chunk;
+    int first;
+} _container_stream;
+
+static void _put_le32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static uint32_t _get_le32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int container_set_aead(int aead) {
+    if (aead != CONTAINER_AEAD_AUTO && aead != CONTAINER_AEAD_XCHACHA20 &&
+        aead != CONTAINER_AEAD_AES256GCM) {
+        return -1;
+    }
+    if (aead == CONTAINER_AEAD_AES256GCM &&
+        !container_aead_available(CONTAINER_AEAD_AES256GCM)) {
+        return -1;
+    }
+    _containerAead = aead;
+    return 0;
+}
+
+int container_selected_aead(void) {
+    int aead = _containerAead;
+    // AES-GCM stays opt-in: a container sealed with it cannot be opened on
+    // a CPU without AES support, so new files default to the portable AEAD.
+    return aead == CONTAINER_AEAD_AUTO ? CONTAINER_AEAD_XCHACHA20 : aead;
+}
+
+int container_aead_available(int aead) {
+    if (aead == CONTAINER_AEAD_XCHACHA20) return 1;
+    if (aead != CONTAINER_AEAD_AES256GCM || sodium_init() < 0) return 0;
+    // libsodium's AES-GCM needs AES-NI+CLMUL (x86) or the ARMv8 crypto
+    // extensions; crypto_aead_aes256gcm_is_available() probes the CPU.
+    return crypto_aead_aes256gcm_is_available() ? 1 : 0;
+}
+
+// AES-GCM containers never reuse the caller key directly: a per-container
+// subkey is derived from a random salt stored in the header, so the 96-bit
+// nonce can simply be (record counter, last-record flag).
+static int _container_gcm_init(_container_stream* cs, const unsigned char* salt,
+                               const uint8_t* key) {
+    static const unsigned char ctx[] = "NHC1 aes256gcm subkey";
+    unsigned char in[_CONTAINER_SALT_BYTES + sizeof ctx];
+    unsigned char subkey[crypto_aead_aes256gcm_KEYBYTES];
+    memcpy(in, salt, _CONTAINER_SALT_BYTES);
+    memcpy(in + _CONTAINER_SALT_BYTES, ctx, sizeof ctx);
+
+    int rc = crypto_generichash_blake2b(subkey, sizeof subkey, in, sizeof in,
+                                        key, crypto_aead_aes256gcm_KEYBYTES);
+    if (rc == 0) rc = crypto_aead_aes256gcm_beforenm(&cs->st.gcm, subkey);
+    sodium_memzero(subkey, sizeof subkey);
+    cs->counter = 0;
+    return rc;
+}
+
+static void _container_gcm_nonce(unsigned char nonce[crypto_aead_aes256gcm_NPUBBYTES],
+                                 uint64_t counter, int last) {
+    memset(nonce, 0, crypto_aead_aes256gcm_NPUBBYTES);
+    _put_le32(nonce, (uint32_t)counter);
+    _put_le32(nonce + 4, (uint32_t)(counter >> 32));
+    nonce[crypto_aead_aes256gcm_NPUBBYTES - 1] = last ? 1 : 0;
+}
+
+// Common setup: first-record associated data and the optional hash state.
+static int _container_init(_container_stream* cs, const unsigned char* prefix,
+                           const uint8_t* ad, size_t ad_len, int hash_alg,
+                           const uint8_t* digest, size_t digest_len) {
+    cs->hash = NULL;
+    cs->ad = NULL;
+    cs->first = 1;
+    if (ad == NULL && ad_len > 0) return -1;
+    cs->ad_len = CONTAINER_PREFIX_BYTES + ad_len;
+    cs->ad = malloc(cs->ad_len);
+    if (cs->ad == NULL) return -1;
+    memcpy(cs->ad, prefix, CONTAINER_PREFIX_BYTES);
+    if (ad_len > 0) memcpy(cs->ad + CONTAINER_PREFIX_BYTES, ad, ad_len);
+
+    if (hash_alg == 0 || digest == NULL) return 0;
+    cs->hash = hash_ctx_new(hash_alg, hash_alg == HASH_ALG_SHA256 ? 0 : digest_len);
+    return cs->hash == NULL ? -1 : 0;
+}
+
+// Writes the 40-byte container header and prepares [cs] for pushing chunks.
+static int _container_push_init(_container_stream* cs,
+                                unsigned char header[CONTAINER_HEADER_BYTES],
+                                const uint8_t* key,
+                                const uint8_t* ad, size_t ad_len, int hash_alg,
+                                const uint8_t* digest, size_t digest_len) {
+    cs->aead = container_selected_aead();
+    cs->abytes = (cs->aead == CONTAINER_AEAD_AES256GCM)
+        ? crypto_aead_aes256gcm_ABYTES
+        : crypto_secretstream_xchacha20poly1305_ABYTES;
+
+    memset(header, 0, CONTAINER_PREFIX_BYTES);
+    memcpy(header, CONTAINER_MAGIC, 4);
+    header[4] = CONTAINER_VERSION;
+    header[5] = (unsigned char)cs->aead;
+    header[6] = ad_len > 0 ? CONTAINER_FLAG_BOUND_AD : 0;
+    _put_le32(header + 8, CONTAINER_CHUNK_BYTES);
+
+    cs->chunk = CONTAINER_CHUNK_BYTES;
+    if (_container_init(cs, header, ad, ad_len, hash_alg, digest, digest_len) != 0) {
+        return -1;
+    }
+    if (cs->aead == CONTAINER_AEAD_AES256GCM) {
+        if (rng_fill(header + CONTAINER_PREFIX_BYTES, _CONTAINER_SALT_BYTES) != 0) {
+            return -1;
+        }
+        return _container_gcm_init(cs, header + CONTAINER_PREFIX_BYTES, key);
+    }
+    return crypto_secretstream_xchacha20poly1305_init_push(
+        &cs->st.ss, header + CONTAINER_PREFIX_BYTES, key);
+}
+
+// Hashes and encrypts one plaintext chunk; writes n + abytes bytes to [out].
+static int _container_push(_container_stream* cs, const unsigned char* in,
+                           size_t n, int last, unsigned char* out) {
+    if (cs->hash && hash_ctx_update(cs->hash, in, n) != 0) return -1;
+    const unsigned char* ad = cs->first ? cs->ad : NULL;
+    size_t ad_len = cs->first ? cs->ad_len : 0;
+    cs->first = 0;
+
+    if (cs->aead == CONTAINER_AEAD_AES256GCM) {
+        unsigned char nonce[crypto_aead_aes256gcm_NPUBBYTES];
+        _container_gcm_nonce(nonce, cs->counter++, last);
+        return crypto_aead_aes256gcm_encrypt_afternm(
+            out, NULL, in, n, ad, ad_len, NULL, nonce, &cs->st.gcm);
+    }
+    return crypto_secretstream_xchacha20poly1305_push(
+        &cs->st.ss, out, NULL, in, n, ad, ad_len,
+        last ? crypto_secretstream_xchacha20poly1305_TAG_FINAL
+             : crypto_secretstream_xchacha20poly1305_TAG_MESSAGE);
+}
+
+// Validates a container header and prepares [cs] for pulling chunks.
+static int _container_pull_init(_container_stream* cs,
+                                const unsigned char header[CONTAINER_HEADER_BYTES],
+                                const uint8_t* key,
+                                const uint8_t* ad, size_t ad_len, int hash_alg,
+                                const uint8_t* digest, size_t digest_len) {
+    cs->ad = NULL;
+    cs->hash = NULL;
+    if (memcmp(header, CONTAINER_MAGIC, 4) != 0 ||
+        header[4] != CONTAINER_VERSION) {
+        return -1;
+    }
+    cs->aead = header[5];
+    if (cs->aead == CONTAINER_AEAD_XCHACHA20) {
+        cs->abytes = crypto_secretstream_xchacha20poly1305_ABYTES;
+    } else if (cs->aead == CONTAINER_AEAD_AES256GCM) {
+        // Containers sealed on AES-capable hardware cannot be opened on a
+        // CPU without it; libsodium has no portable AES-GCM fallback.
+        if (!crypto_aead_aes256gcm_is_available()) return -1;
+        cs->abytes = crypto_aead_aes256gcm_ABYTES;
+    } else {
+        return -1;
+    }
+    // The caller's expectation of a binding must match the container's.
+    int bound = (header[6] & CONTAINER_FLAG_BOUND_AD) != 0;
+    if (bound != (ad_len > 0)) return -1;
+
+    cs->chunk = _get_le32(header + 8);
+    if (cs->chunk == 0 || cs->chunk > _CONTAINER_MAX_CHUNK) return -1;
+
+    if (_container_init(cs, header, ad, ad_len, hash_alg, digest, digest_len) != 0) {
+        return -1;
+    }
+    if (cs->aead == CONTAINER_AEAD_AES256GCM) {
+        return _container_gcm_init(cs, header + CONTAINER_PREFIX_BYTES, key);
+    }
+    return crypto_secretstream_xchacha20poly1305_init_pull(
+        &cs->st.ss, header + CONTAINER_PREFIX_BYTES, key);
+}
+
+// Decrypts one record of [clen] bytes into [out]; [*n] receives the plaintext
+// length and [*final] whether this record closed the stream.
+static int _container_pull(_container_stream* cs, const unsigned char* in,
+                           size_t clen, unsigned char* out,
+                           size_t* n, int* final) {
+    if (clen < cs->abytes) return -1;
+    const unsigned char* ad = cs->first ? cs->ad : NULL;
+    size_t ad_len = cs->first ? cs->ad_len : 0;
+    cs->first = 0;
+
+    unsigned long long mlen;
+    if (cs->aead == CONTAINER_AEAD_AES256GCM) {
+        // The last-record flag lives in the nonce: a record only verifies
+        // under the flag it was sealed with, which rules out truncation.
+        unsigned char nonce[crypto_aead_aes256gcm_NPUBBYTES];
+        *final = 0;
+        _container_gcm_nonce(nonce, cs->counter, 0);
+        if (crypto_aead_aes256gcm_decrypt_afternm(
+                out, &mlen, NULL, in, clen, ad, ad_len, nonce, &cs->st.gcm) != 0) {
+            *final = 1;
+            _container_gcm_nonce(nonce, cs->counter, 1);
+            if (crypto_aead_aes256gcm_decrypt_afternm(
+                    out, &mlen, NULL, in, clen, ad, ad_len, nonce, &cs->st.gcm) != 0) {
+                return -1;
+            }
+        }
+        cs->counter++;
+    } else {
+        unsigned char tag;
+        if (crypto_secretstream_xchacha20poly1305_pull(
+                &cs->st.ss, out, &mlen, &tag, in, clen, ad, ad_len) != 0) {
+            return -1;
+        }
+        *final = (tag == crypto_secretstream_xchacha20poly1305_TAG_FINAL);
+    }
+    *n = (size_t)mlen;
+    if (cs->hash && hash_ctx_update(cs->hash, out, *n) != 0) return -1;
+    return 0;
+}
+
+// Emits the digest (if requested) and wipes the stream state. Always call
+// this exactly once, passing ok = 0 on error paths to skip the digest.
+static int _container_finish(_container_stream* cs, int ok,
+                             uint8_t* digest, size_t digest_len) {
+    int rc = ok ? 0 : -1;
+    if (cs->hash) {
+        if (ok && hash_ctx_final(cs->hash, digest, digest_len) < 0) rc = -1;
+        hash_ctx_free(cs->hash);
+    }
+    free(cs->ad);
+    sodium_memzero(cs, sizeof *cs);
+    return rc;
+}
+
+size_t container_encrypted_size(size_t plain_len) {
+    size_t chunks = plain_len / CONTAINER_CHUNK_BYTES + 1; // FINAL record
+    if (plain_len > 0 && plain_len % CONTAINER_CHUNK_BYTES == 0) chunks--;
+    return CONTAINER_HEADER_BYTES + plain_len + chunks * _CONTAINER_MAX_ABYTES;
+}
+
+int container_is_container(const uint8_t* data, size_t len) {
+    return data != NULL && len >= CONTAINER_HEADER_BYTES &&
+           memcmp(data, CONTAINER_MAGIC, 4) == 0;
+}
+
+int container_flags(const uint8_t* data, size_t len) {
+    return container_is_container(data, len) ? data[6] : -1;
+}
+
+int encrypt_buffer_hashed(const uint8_t* data, size_t len,
+                          const uint8_t* key, size_t key_len,
+                          const uint8_t* ad, size_t ad_len,
+                          int hash_alg, uint8_t* digest, size_t digest_len,
+                          uint8_t* out, size_t out_cap, size_t* out_len) {
+    STATS_SCOPE(STATS_FN_ENCRYPT_BUFFER_HASHED, len);
+    if (key_len != crypto_secretstream_xchacha20poly1305_KEYBYTES) return -1;
+    if ((data == NULL && len > 0) || out == NULL || out_len == NULL) return -1;
+    if (out_cap < container_encrypted_size(len)) return -1;
+    if (sodium_init() < 0) return -1;
+
+    _container_stream cs;
+    if (_container_push_init(&cs, out, key, ad, ad_len,
+                             hash_alg, digest, digest_len) != 0) {
+        return _container_finish(&cs, 0, NULL, 0);
+    }
+
+    size_t off = 0;
+    unsigned char* w = out + CONTAINER_HEADER_BYTES;
+    do {
+        size_t n = len - off;
+        if (n > CONTAINER_CHUNK_BYTES) n = CONTAINER_CHUNK_BYTES;
+        int last = (off + n == len);
+        if (_container_push(&cs, data + off, n, last, w) != 0) {
+            return _container_finish(&cs, 0, NULL, 0);
+        }
+        off += n;
+        w += n + cs.abytes;
+    } while (off < len);
+
+    *out_len = (size_t)(w - out);
+    return _container_finish(&cs, 1, digest, digest_len);
+}
+
+int decrypt_buffer_hashed(const uint8_t* data, size_t len,
+                          const uint8_t* key, size_t key_len,
+                          const uint8_t* ad, size_t ad_len,
+                          int hash_alg, uint8_t* digest, size_t digest_len,
+                          uint8_t* out, size_t out_cap, size_t* out_len) {
+    STATS_SCOPE(STATS_FN_DECRYPT_BUFFER_HASHED, len);
+    if (key_len != crypto_secretstream_xchacha20poly1305_KEYBYTES) return -1;
+    if (!container_is_container(data, len) || out == NULL || out_len == NULL) {
+        return -1;
+    }
+    if (out_cap < len) return -1;
+    if (sodium_init() < 0) return -1;
+
+    _container_stream cs;
+    if (_container_pull_init(&cs, data, key, ad, ad_len,
+                             hash_alg, digest, digest_len) != 0) {
+        return _container_finish(&cs, 0, NULL, 0);
+    }
+
+    const size_t record = (size_t)cs.chunk + cs.abytes;
+    size_t off = CONTAINER_HEADER_BYTES;
+    size_t written = 0;
+    int final = 0;
+    while (!final) {
+        size_t clen = len - off;
+        if (clen > record) clen = record;
+        size_t n;
+        if (_container_pull(&cs, data + off, clen, out + written, &n, &final) != 0) {
+            sodium_memzero(out, written);
+            return _container_finish(&cs, 0, NULL, 0);
+        }
+        off += clen;
+        written += n;
+        // Trailing bytes after FINAL, or no FINAL before the end: reject.
+        if (final != (off == len)) {
+            sodium_memzero(out, written);
+            return _container_finish(&cs, 0, NULL, 0);
+        }
+    }
+
+    *out_len = written;
+    return _container_finish(&cs, 1, digest, digest_len);
+}
+
+int encrypt_file_hashed(const char* in_path, const char* out_path,
+                        const uint8_t* key, size_t key_len,
+                        const uint8_t* ad, size_t ad_len,
+                        int hash_alg, uint8_t* digest, size_t digest_len) {
+    STATS_SCOPE(STATS_FN_ENCRYPT_FILE_HASHED, 0);
+    if (key_len != crypto_secretstream_xchacha20poly1305_KEYBYTES) return -1;
+    if (in_path == NULL || out_path == NULL) return -1;
+    if (sodium_init() < 0) return -1;
+
+    FILE* in = fopen(in_path, "rb");
+    if (in == NULL) return -1;
+    FILE* out = fopen(out_path, "wb");
+    if (out == NULL) {
+        fclose(in);
+        return -1;
+    }
+
+    // Two plaintext buffers so we can read one block ahead and know which
+    // block is the last one without stat()ing the input.
+    unsigned char* cur = secmem_alloc(CONTAINER_CHUNK_BYTES);
+    unsigned char* next = secmem_alloc(CONTAINER_CHUNK_BYTES);
+    unsigned char* cipher = malloc(CONTAINER_CHUNK_BYTES + _CONTAINER_MAX_ABYTES);
+    unsigned char header[CONTAINER_HEADER_BYTES];
+    _container_stream cs;
+    int ok = 0;
+
+    if (cur == NULL || next == NULL || cipher == NULL) goto done;
+    if (_container_push_init(&cs, header, key, ad, ad_len,
+                             hash_alg, digest, digest_len) != 0) {
+        _container_finish(&cs, 0, NULL, 0);
+        goto done;
+    }
+    if (fwrite(header, 1, sizeof header, out) != sizeof header) {
+        _container_finish(&cs, 0, NULL, 0);
+        goto done;
+    }
+
+    size_t n = fread(cur, 1, CONTAINER_CHUNK_BYTES, in);
+    for (;;) {
+        size_t next_n = (n == CONTAINER_CHUNK_BYTES)
+            ? fread(next, 1, CONTAINER_CHUNK_BYTES, in) : 0;
+        if (ferror(in)) break;
+        int last = (next_n == 0);
+        if (_container_push(&cs, cur, n, last, cipher) != 0) break;
+        if (fwrite(cipher, 1, n + cs.abytes, out) != n + cs.abytes) {
+            break;
+        }
+        STATS_ADD_BYTES(n);
+        if (last) {
+            ok = 1;
+            break;
+        }
+        unsigned char* tmp = cur;
+        cur = next;
+        next = tmp;
+        n = next_n;
+    }
+    ok = (_container_finish(&cs, ok, digest, digest_len) == 0);
+
+done:
+    secmem_free(cur, CONTAINER_CHUNK_BYTES);
+    secmem_free(next, CONTAINER_CHUNK_BYTES);
+    free(cipher);
+    fclose(in);
+    if (fclose(out) != 0) ok = 0;
+    if (!ok) remove(out_path);
+    return ok ? 0 : -1;
+}
+
+int decrypt_file_hashed(const char* in_path, const char* out_path,
+                        const uint8_t* key, size_t key_len,
+                        const uint8_t* ad, size_t ad_len,
+                        int hash_alg, uint8_t* digest, size_t digest_len) {
+    STATS_SCOPE(STATS_FN_DECRYPT_FILE_HASHED, 0);
+    if (key_len != crypto_secretstream_xchacha20poly1305_KEYBYTES) return -1;
+    if (in_path == NULL || out_path == NULL) return -1;
+    if (sodium_init() < 0) return -1;
+
+    FILE* in = fopen(in_path, "rb");
+    if (in == NULL) return -1;
+
+    unsigned char header[CONTAINER_HEADER_BYTES];
+    if (fread(header, 1, sizeof header, in) != sizeof header) {
+        fclose(in);
+        return -1;
+    }
+
+    _container_stream cs;
+    if (_container_pull_init(&cs, header, key, ad, ad_len,
+                             hash_alg, digest, digest_len) != 0) {
+        _container_finish(&cs, 0, NULL, 0);
+        fclose(in);
+        return -1;
+    }
+
+    FILE* out = fopen(out_path, "wb");
+    const size_t chunk = cs.chunk;
+    const size_t record = chunk + cs.abytes;
+    unsigned char* cipher = malloc(record);
+    unsigned char* plain = secmem_alloc(chunk);
+    int ok = 0;
+
+    if (out != NULL && cipher != NULL && plain != NULL) {
+        for (;;) {
+            size_t clen = fread(cipher, 1, record, in);
+            if (ferror(in)) break;
+            size_t n;
+            int final;
+            if (_container_pull(&cs, cipher, clen, plain, &n, &final) != 0) break;
+            if (fwrite(plain, 1, n, out) != n) break;
+            STATS_ADD_BYTES(n);
+            if (final) {
+                ok = (fgetc(in) == EOF); // nothing may follow the FINAL record
+                break;
+            }
+            if (clen < record) break; // truncated: EOF without FINAL tag
+        }
+    }
+    ok = (_container_finish(&cs, ok, digest, digest_len) == 0);
+
+    secmem_free(plain, chunk);
+    free(cipher);
+    fclose(in);
+    if (out != NULL && fclose(out) != 0) ok = 0;
+    if (!ok && out != NULL) remove(out_path);
+    return ok ? 0 : -1;
+}
+
+/* ---------------------------------------------------------------------------
+ *  ONE-TIME PASSWORDS
+ *
+ *  HMAC-SHA256/512 come from libsodium. libsodium has no SHA-1, which RFC
+ *  6238 authenticators still default to, so a minimal SHA-1 is kept here
+ *  for HMAC use only. Everything runs on the stack: a verification makes no
+ *  heap allocation.
+ * -------------------------------------------------------------------------*/
+
+#define _OTP_MAX_SECRET 128
+#define _OTP_MAX_WINDOW 10
+
+struct otp_key {
+    int alg;
+    size_t len;
+    uint8_t secret[_OTP_MAX_SECRET];
+};
+
+typedef struct {
+    uint32_t h[5];
+    uint64_t bytes;
+    uint8_t buf[64];
+    size_t used;
+} _sha1_ctx;
+
+#define _ROL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void _sha1_block(uint32_t h[5], const uint8_t p[64]) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t)p[4 * i] << 24 | (uint32_t)p[4 * i + 1] << 16 |
+               (uint32_t)p[4 * i + 2] << 8 | (uint32_t)p[4 * i + 3];
+    }
+    for (int i = 16; i < 80; ++i) {
+        w[i] = _ROL32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+        else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+        else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+        else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+        uint32_t t = _ROL32(a, 5) + f + e + k + w[i];
+        e = d; d = c; c = _ROL32(b, 30); b = a; a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    sodium_memzero(w, sizeof w);
+}
+
+static void _sha1_init(_sha1_ctx* c) {
+    c->h[0] = 0x67452301; c->h[1] = 0xEFCDAB89; c->h[2] = 0x98BADCFE;
+    c->h[3] = 0x10325476; c->h[4] = 0xC3D2E1F0;
+    c->bytes = 0;
+    c->used = 0;
+}
+
+static void _sha1_update(_sha1_ctx* c, const uint8_t* p, size_t n) {
+    c->bytes += n;
+    while (n > 0) {
+        size_t take = 64 - c->used;
+        if (take > n) take = n;
+        memcpy(c->buf + c->used, p, take);
+        c->used += take;
+        p += take;
+        n -= take;
+        if (c->used == 64) {
+            _sha1_block(c->h, c->buf);
+            c->used = 0;
+        }
+    }
+}
+
+static void _sha1_final(_sha1_ctx* c, uint8_t out[20]) {
+    uint64_t bits = c->bytes * 8;
+    uint8_t pad = 0x80;
+    _sha1_update(c, &pad, 1);
+    pad = 0;
+    while (c->used != 56) _sha1_update(c, &pad, 1);
+    uint8_t len[8];
+    for (int i = 0; i < 8; ++i) len[i] = (uint8_t)(bits >> (56 - 8 * i));
+    _sha1_update(c, len, 8);
+    for (int i = 0; i < 5; ++i) {
+        out[4 * i] = (uint8_t)(c->h[i] >> 24);
+        out[4 * i + 1] = (uint8_t)(c->h[i] >> 16);
+        out[4 * i + 2] = (uint8_t)(c->h[i] >> 8);
+        out[4 * i + 3] = (uint8_t)c->h[i];
+    }
+    sodium_memzero(c, sizeof *c);
+}
+
+static void _hmac_sha1(const uint8_t* key, size_t key_len,
+                       const uint8_t* msg, size_t msg_len, uint8_t out[20]) {
+    uint8_t k[64] = {0};
+    uint8_t pad[64];
+    _sha1_ctx c;
+
+    if (key_len > 64) {
+        _sha1_init(&c);
+        _sha1_update(&c, key, key_len);
+        _sha1_final(&c, k);
+    } else {
+        memcpy(k, key, key_len);
+    }
+
+    for (int i = 0; i < 64; ++i) pad[i] = k[i] ^ 0x36;
+    _sha1_init(&c);
+    _sha1_update(&c, pad, 64);
+    _sha1_update(&c, msg, msg_len);
+    _sha1_final(&c, out);
+
+    for (int i = 0; i < 64; ++i) pad[i] = k[i] ^ 0x5c;
+    _sha1_init(&c);
+    _sha1_update(&c, pad, 64);
+    _sha1_update(&c, out, 20);
+    _sha1_final(&c, out);
+
+    sodium_memzero(k, sizeof k);
+    sodium_memzero(pad, sizeof pad);
+}
+
+otp_key* otp_key_new(int alg, const uint8_t* secret, size_t secret_len) {
+    if (alg < OTP_ALG_SHA1 || alg > OTP_ALG_SHA512 || secret == NULL ||
+        secret_len == 0 || secret_len > _OTP_MAX_SECRET) {
+        return NULL;
+    }
+    if (sodium_init() < 0) return NULL;
+
+    otp_key* key = sodium_malloc(sizeof(otp_key));
+    if (key == NULL) return NULL;
+    key->alg = alg;
+    key->len = secret_len;
+    memcpy(key->secret, secret, secret_len);
+    sodium_mprotect_readonly(key);
+    return key;
+}
+
+otp_key* otp_key_new_base32(int alg, const char* secret_b32) {
+    if (secret_b32 == NULL) return NULL;
+
+    uint8_t secret[_OTP_MAX_SECRET];
+    int64_t len = base32_decode(secret_b32, strlen(secret_b32),
+                                secret, sizeof secret);
+
+    otp_key* key = len > 0 ? otp_key_new(alg, secret, (size_t)len) : NULL;
+    sodium_memzero(secret, sizeof secret);
+    return key;
+}
+
+void otp_key_free(otp_key* key) {
+    if (key == NULL) return;
+    sodium_free(key); // sodium_free() wipes before releasing
+}
+
+static const uint64_t _otpPow10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+    10000000ull, 100000000ull, 1000000000ull, 10000000000ull};
+
+int64_t hotp_generate(const otp_key* key, uint64_t counter, int digits) {
+    STATS_SCOPE(STATS_FN_HOTP_GENERATE, 0);
+    if (key == NULL || digits < 6 || digits > 10) return -1;
+
+    uint8_t msg[8];
+    for (int i = 7; i >= 0; --i) {
+        msg[i] = (uint8_t)counter;
+        counter >>= 8;
+    }
+
+    uint8_t mac[crypto_auth_hmacsha512_BYTES];
+    size_t mac_len;
+    switch (key->alg) {
+    case OTP_ALG_SHA1:
+        _hmac_sha1(key->secret, key->len, msg, sizeof msg, mac);
+        mac_len = 20;
+        break;
+    case OTP_ALG_SHA256: {
+        crypto_auth_hmacsha256_state st;
+        crypto_auth_hmacsha256_init(&st, key->secret, key->len);
+        crypto_auth_hmacsha256_update(&st, msg, sizeof msg);
+        crypto_auth_hmacsha256_final(&st, mac);
+        sodium_memzero(&st, sizeof st);
+        mac_len = crypto_auth_hmacsha256_BYTES;
+        break;
+    }
+    case OTP_ALG_SHA512: {
+        crypto_auth_hmacsha512_state st;
+        crypto_auth_hmacsha512_init(&st, key->secret, key->len);
+        crypto_auth_hmacsha512_update(&st, msg, sizeof msg);
+        crypto_auth_hmacsha512_final(&st, mac);
+        sodium_memzero(&st, sizeof st);
+        mac_len = crypto_auth_hmacsha512_BYTES;
+        break;
+    }
+    default:
+        return -1;
+    }
+
+    // RFC 4226 dynamic truncation.
+    size_t off = mac[mac_len - 1] & 0x0f;
+    uint32_t bin = ((uint32_t)(mac[off] & 0x7f) << 24) |
+                   ((uint32_t)mac[off + 1] << 16) |
+                   ((uint32_t)mac[off + 2] << 8) | (uint32_t)mac[off + 3];
+    sodium_memzero(mac, sizeof mac);
+    return (int64_t)(bin % _otpPow10[digits]);
+}
+
+int64_t totp_generate(const otp_key* key, uint64_t unix_time, uint32_t step,
+                      int digits) {
+    if (step == 0) return -1;
+    return hotp_generate(key, unix_time / step, digits);
+}
+
+int totp_verify(const otp_key* key, uint64_t unix_time, uint32_t step,
+                int digits, uint64_t code, uint32_t window,
+                int32_t* matched_offset) {
+    STATS_SCOPE(STATS_FN_TOTP_VERIFY, 0);
+    if (key == NULL || step == 0 || digits < 6 || digits > 10 ||
+        window > _OTP_MAX_WINDOW) {
+        return -1;
+    }
+
+    const uint64_t counter = unix_time / step;
+    uint64_t found = 0;     // all-ones once any candidate matched
+    uint64_t offset = 0;
+    for (int64_t i = -(int64_t)window; i <= (int64_t)window; ++i) {
+        if ((int64_t)counter + i < 0) continue; // only near the epoch
+        int64_t expected = hotp_generate(key, (uint64_t)((int64_t)counter + i),
+                                         digits);
+        uint64_t diff = (uint64_t)expected ^ code;
+        // eq = all-ones iff diff == 0, without a data-dependent branch.
+        uint64_t eq = ((diff | (0 - diff)) >> 63) - 1;
+        offset |= eq & ~found & (uint64_t)i;
+        found |= eq;
+    }
+
+    if (matched_offset) *matched_offset = (int32_t)offset;
+    return (int)(found & 1);
+}
+
+
+// --- Startup warm-up ---------------------------------------------------------
+
+#define _WARMUP_MAX_CALLBACKS 4
+
+enum { _WARMUP_IDLE, _WARMUP_RUNNING, _WARMUP_DONE };
+
+static pthread_mutex_t _warmupLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _warmupCond = PTHREAD_COND_INITIALIZER;
+static int _warmupState = _WARMUP_IDLE;
+static crypto_warmup_report _warmupReport;
+static crypto_warmup_cb _warmupCallbacks[_WARMUP_MAX_CALLBACKS];
+static int _warmupCallbackCount = 0;
+
+static uint64_t _warmup_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void _warmup_run(uint32_t flags, crypto_warmup_report* r) {
+    memset(r, 0, sizeof *r);
+    r->version = WARMUP_REPORT_VERSION;
+    const uint64_t start = _warmup_now_ns();
+
+    uint64_t t = start;
+    r->status = sodium_init() < 0 ? -1 : 0;
+    (void)secmem_init(); // maps and mlock()s the secure pool
+    r->sodium_init_ns = _warmup_now_ns() - t;
+    if (r->status != 0) {
+        r->total_ns = _warmup_now_ns() - start;
+        return;
+    }
+
+    t = _warmup_now_ns();
+    r->opslimit = _kdf_opslimit();
+    r->memlimit = _kdf_memlimit();
+    r->kdf_select_ns = _warmup_now_ns() - t;
+
+    // Argon2 maps a fresh arena per call, so the pages cannot be kept for
+    // the unlock; this only moves reclaim pressure earlier. Opt-in, since it
+    // costs memlimit bytes of memory and CPU on launches that never unlock.
+    if (flags & WARMUP_FLAG_KDF_ARENA) {
+        static const unsigned char salt[crypto_pwhash_SALTBYTES] = {0};
+        unsigned char out[16];
+        t = _warmup_now_ns();
+        crypto_pwhash(out, sizeof out, "", 0, salt,
+                      crypto_pwhash_OPSLIMIT_MIN, r->memlimit,
+                      crypto_pwhash_alg_default());
+        r->kdf_arena_ns = _warmup_now_ns() - t;
+    }
+
+    t = _warmup_now_ns();
+    (void)codec_simd_level();
+    (void)container_aead_available(CONTAINER_AEAD_AES256GCM);
+    r->cpu_probe_ns = _warmup_now_ns() - t;
+
+    r->total_ns = _warmup_now_ns() - start;
+}
+
+// Runs the warm-up if nobody has, then wakes waiters and fires callbacks.
+// A failed run goes back to idle so the next caller retries. Called with
+// _warmupLock held and state == _WARMUP_RUNNING; returns with the lock
+// released.
+static void _warmup_complete(uint32_t flags) {
+    pthread_mutex_unlock(&_warmupLock);
+    crypto_warmup_report report;
+    _warmup_run(flags, &report);
+
+    pthread_mutex_lock(&_warmupLock);
+    _warmupReport = report;
+    _warmupState = report.status == 0 ? _WARMUP_DONE : _WARMUP_IDLE;
+    crypto_warmup_cb callbacks[_WARMUP_MAX_CALLBACKS];
+    const int count = _warmupCallbackCount;
+    memcpy(callbacks, _warmupCallbacks, sizeof callbacks);
+    _warmupCallbackCount = 0;
+    pthread_cond_broadcast(&_warmupCond);
+    pthread_mutex_unlock(&_warmupLock);
+
+    for (int i = 0; i < count; ++i) callbacks[i](&_warmupReport);
+}
+
+static void* _warmup_thread(void* arg) {
+    pthread_mutex_lock(&_warmupLock);
+    _warmup_complete((uint32_t)(uintptr_t)arg);
+    return NULL;
+}
+
+int native_crypto_warmup(uint32_t flags, crypto_warmup_report* report) {
+    pthread_mutex_lock(&_warmupLock);
+    if (_warmupState == _WARMUP_IDLE) {
+        _warmupState = _WARMUP_RUNNING;
+        _warmup_complete(flags);
+        pthread_mutex_lock(&_warmupLock);
+    }
+    while (_warmupState == _WARMUP_RUNNING) {
+        pthread_cond_wait(&_warmupCond, &_warmupLock);
+    }
+    const crypto_warmup_report result = _warmupReport;
+    pthread_mutex_unlock(&_warmupLock);
+
+    if (report != NULL) *report = result;
+    return result.status;
+}
+
+int native_crypto_warmup_start(uint32_t flags, crypto_warmup_cb cb) {
+    pthread_mutex_lock(&_warmupLock);
+    if (_warmupState == _WARMUP_DONE) {
+        pthread_mutex_unlock(&_warmupLock);
+        if (cb != NULL) cb(&_warmupReport);
+        return 0;
+    }
+    if (cb != NULL) {
+        if (_warmupCallbackCount == _WARMUP_MAX_CALLBACKS) {
+            pthread_mutex_unlock(&_warmupLock);
+            return -1;
+        }
+        _warmupCallbacks[_warmupCallbackCount++] = cb;
+    }
+    int rc = 0;
+    if (_warmupState == _WARMUP_IDLE) {
+        pthread_t tid;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&tid, &attr, _warmup_thread,
+                           (void*)(uintptr_t)flags) == 0) {
+            _warmupState = _WARMUP_RUNNING;
+        } else {
+            if (cb != NULL) --_warmupCallbackCount;
+            rc = -1;
+        }
+        pthread_attr_destroy(&attr);
+    }
+    pthread_mutex_unlock(&_warmupLock);
+    return rc;
+}
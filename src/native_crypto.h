@@ -36,6 +36,19 @@ char* encrypt_bytes(const uint8_t* data, size_t len,
 char* decrypt_bytes(const char* enc_b64,
                     const uint8_t* key, size_t key_len);
 
+// Variants of encrypt_bytes()/decrypt_bytes() that authenticate [ad_len]
+// bytes of associated data at [ad] without encrypting them (e.g. record id,
+// version and type). The same associated data must be supplied to decrypt;
+// any mismatch fails exactly like a bad MAC. Passing NULL/0 is equivalent to
+// the plain functions, so blobs are interchangeable.
+char* encrypt_bytes_ad(const uint8_t* data, size_t len,
+                       const uint8_t* key, size_t key_len,
+                       const uint8_t* ad, size_t ad_len);
+
+char* decrypt_bytes_ad(const char* enc_b64,
+                       const uint8_t* key, size_t key_len,
+                       const uint8_t* ad, size_t ad_len);
+
 // === Added FFI helpers for Dart ===
 
 // Fills \[len] bytes of cryptographically-secure random data into [buf].
@@ -69,4 +82,229 @@ char* pbkdf2_sha256_b64(const char* password,
                         const uint8_t* salt, size_t salt_len,
                         size_t dk_len);
 
+// === Native hashing (SHA-256 / BLAKE2b) ===
+
+// Algorithm identifiers accepted by the hashing helpers below.
+#define HASH_ALG_SHA256   1 // 32-byte digest
+#define HASH_ALG_BLAKE2B  2 // 16..64-byte digest (32 by default)
+
+// Opaque incremental hashing context. Create with hash_ctx_new(), feed data
+// with hash_ctx_update() and obtain the digest with hash_ctx_final(). The
+// context must always be released with hash_ctx_free().
+typedef struct hash_ctx hash_ctx;
+
+// Creates a hashing context for [alg]. [digest_len] is ignored for SHA-256;
+// for BLAKE2b pass 0 to get the default 32-byte digest. Returns NULL on
+// failure (unknown algorithm, invalid length or out of memory).
+hash_ctx* hash_ctx_new(int alg, size_t digest_len);
+
+// Absorbs [len] bytes at [data]. Returns 0 on success, -1 on failure.
+int hash_ctx_update(hash_ctx* ctx, const uint8_t* data, size_t len);
+
+// Writes the digest into [out] (which must hold at least the digest length).
+// Returns the number of bytes written, or -1 on failure. The context cannot
+// be updated afterwards.
+int hash_ctx_final(hash_ctx* ctx, uint8_t* out, size_t out_len);
+
+// Wipes and frees a context created by hash_ctx_new(). NULL is ignored.
+void hash_ctx_free(hash_ctx* ctx);
+
+// One-shot helper: hashes [len] bytes at [data] into [out]. Returns the
+// digest length written, or -1 on failure.
+int hash_bytes(int alg, const uint8_t* data, size_t len,
+               uint8_t* out, size_t out_len);
+
+// Streams the file at [path] through the hash in fixed-size chunks without
+// loading it into memory. Returns the digest length written, or -1 on failure
+// (including I/O errors).
+int hash_file(int alg, const char* path, uint8_t* out, size_t out_len);
+
+// === Fused encrypt-and-hash container (single pass) ===
+//
+// Layout (all integers little-endian):
+//   [0..3]   magic "NHC1"
+//   [4]      container version (CONTAINER_VERSION)
+//   [5]      AEAD algorithm (CONTAINER_AEAD_*)
+//   [6]      flags (CONTAINER_FLAG_*)
+//   [7]      reserved (0)
+//   [8..11]  plaintext chunk size in bytes
+//   [12..15] reserved (0)
+//   [16..39] XChaCha20: secretstream header / AES-GCM: subkey salt
+//   then one (chunk + tag) record per chunk (17-byte tag for XChaCha20, 16
+//   for AES-GCM); the last record is marked final (secretstream FINAL tag,
+//   or the last-record bit of the AES-GCM nonce). The 16-byte prefix,
+//   followed by any caller-supplied associated data, is authenticated as
+//   associated data of the first record only.
+//
+//   XChaCha20 (secretstream): each record's MAC depends on the stream state
+//   left by all earlier records, so every record is chained to the first.
+//   AES-GCM: records are authenticated independently. They are tied to
+//   this container by the subkey derived from the caller key and the
+//   header salt, and to their position by the counter nonce; the
+//   last-record bit stops truncation. A record cannot be moved between
+//   containers or reordered, so in both modes binding context (file id,
+//   size, ...) in the associated data authenticates the whole container.
+//
+// Every plaintext block is read once and fed to both the hash state and the
+// AEAD state, so importing a file costs a single pass over memory.
+
+#define CONTAINER_MAGIC          "NHC1"
+#define CONTAINER_VERSION        1
+#define CONTAINER_AEAD_AUTO      0 // default: XChaCha20 (see container_set_aead)
+#define CONTAINER_AEAD_XCHACHA20 1 // XChaCha20-Poly1305 secretstream
+#define CONTAINER_AEAD_AES256GCM 2 // AES-256-GCM, hardware only
+#define CONTAINER_PREFIX_BYTES   16
+#define CONTAINER_HEADER_BYTES   40 // prefix + secretstream header / salt
+#define CONTAINER_CHUNK_BYTES    (64 * 1024)
+
+// Set when the container was sealed with caller associated data. Such a
+// container only opens when the same associated data is supplied, and
+// supplying associated data for a container without the flag fails, so the
+// binding cannot be stripped.
+#define CONTAINER_FLAG_BOUND_AD  0x01
+
+// Selects the AEAD used for new containers. CONTAINER_AEAD_AUTO (default)
+// seals with XChaCha20-Poly1305, which opens on every device.
+// CONTAINER_AEAD_AES256GCM is opt-in: it is faster on CPUs with AES +
+// carry-less multiply support (AES-NI/CLMUL on x86, AES/PMULL on ARMv8),
+// but its containers cannot be opened on hardware without it. Returns -1
+// for unknown ids or AES-GCM on unsupported hardware. Decryption always
+// follows the id recorded in the header.
+int container_set_aead(int aead);
+
+// Returns the CONTAINER_AEAD_* id new containers will be sealed with.
+int container_selected_aead(void);
+
+// Returns 1 if containers recorded with [aead] can be sealed and opened on
+// this CPU, 0 otherwise (AES-GCM without hardware support, unknown ids).
+int container_aead_available(int aead);
+
+// Returns the container size for [plain_len] bytes of plaintext. This is
+// exact for XChaCha20 and an upper bound (one byte per chunk) for AES-GCM;
+// the encrypt functions report the actual size.
+size_t container_encrypted_size(size_t plain_len);
+
+// Returns non-zero when [data] starts with a container header.
+int container_is_container(const uint8_t* data, size_t len);
+
+// Returns the CONTAINER_FLAG_* byte of a container header, or -1 if [data]
+// is not a container.
+int container_flags(const uint8_t* data, size_t len);
+
+// Encrypts [len] bytes at [data] into [out] (capacity [out_cap], see
+// container_encrypted_size()) while hashing the plaintext with [hash_alg]
+// into [digest]. Pass hash_alg = 0 (or digest = NULL) to skip hashing.
+// [ad]/[ad_len] is optional associated data bound to the container (see
+// CONTAINER_FLAG_BOUND_AD). [*out_len] receives the container size. Returns
+// 0 on success, -1 on failure.
+int encrypt_buffer_hashed(const uint8_t* data, size_t len,
+                          const uint8_t* key, size_t key_len,
+                          const uint8_t* ad, size_t ad_len,
+                          int hash_alg, uint8_t* digest, size_t digest_len,
+                          uint8_t* out, size_t out_cap, size_t* out_len);
+
+// Decrypts a container produced by encrypt_buffer_hashed() into [out]
+// (capacity must be >= container length) and hashes the recovered plaintext
+// into [digest] (optional, as above). [ad]/[ad_len] must match what the
+// container was sealed with. [*out_len] receives the plaintext size.
+// Returns 0 on success, -1 on failure (including any authentication
+// failure, associated-data mismatch or truncation).
+int decrypt_buffer_hashed(const uint8_t* data, size_t len,
+                          const uint8_t* key, size_t key_len,
+                          const uint8_t* ad, size_t ad_len,
+                          int hash_alg, uint8_t* digest, size_t digest_len,
+                          uint8_t* out, size_t out_cap, size_t* out_len);
+
+// File-to-file variants of the above. Data is streamed in
+// CONTAINER_CHUNK_BYTES blocks so memory use is independent of file size.
+// On failure the partially written [out_path] is removed.
+int encrypt_file_hashed(const char* in_path, const char* out_path,
+                        const uint8_t* key, size_t key_len,
+                        const uint8_t* ad, size_t ad_len,
+                        int hash_alg, uint8_t* digest, size_t digest_len);
+
+int decrypt_file_hashed(const char* in_path, const char* out_path,
+                        const uint8_t* key, size_t key_len,
+                        const uint8_t* ad, size_t ad_len,
+                        int hash_alg, uint8_t* digest, size_t digest_len);
+
+// --- One-time passwords (RFC 4226 HOTP / RFC 6238 TOTP) ---------------------
+#define OTP_ALG_SHA1   1
+#define OTP_ALG_SHA256 2
+#define OTP_ALG_SHA512 3
+
+// Opaque key handle; the secret lives in guarded, locked sodium_malloc()
+// memory and is read-only after creation.
+typedef struct otp_key otp_key;
+
+// Creates a key from raw secret bytes. Returns NULL on bad arguments.
+otp_key* otp_key_new(int alg, const uint8_t* secret, size_t secret_len);
+
+// Creates a key from an RFC 4648 Base32 secret (case-insensitive, padding
+// and spaces ignored), so the decoded secret never leaves native memory.
+otp_key* otp_key_new_base32(int alg, const char* secret_b32);
+
+// Wipes and frees the key.
+void otp_key_free(otp_key* key);
+
+// Returns the [digits] (6..10) HOTP value for [counter], or -1.
+int64_t hotp_generate(const otp_key* key, uint64_t counter, int digits);
+
+// Returns the TOTP value for [unix_time] with period [step] seconds, or -1.
+int64_t totp_generate(const otp_key* key, uint64_t unix_time, uint32_t step,
+                      int digits);
+
+// Checks [code] against every step in [-window, +window] around
+// [unix_time]. All candidates are computed and compared in constant time,
+// with no early exit. Returns 1 on a match (the step offset goes to
+// [*matched_offset] if not NULL), 0 on no match and -1 on bad arguments.
+int totp_verify(const otp_key* key, uint64_t unix_time, uint32_t step,
+                int digits, uint64_t code, uint32_t window,
+                int32_t* matched_offset);
+
+// --- Startup warm-up ----------------------------------------------------------
+// Pays the one-time costs of the first unlock at launch instead: sodium_init()
+// (CPU feature probes, RNG), KDF parameter selection and the codec/AEAD
+// hardware probes. The KDF entry points never wait for it: sodium_init()
+// and the KDF parameter selection are idempotent and run on their own when
+// an unlock comes first.
+//
+// Fixed layout shared with Dart (ffi.Struct); bump the version on change.
+#define WARMUP_REPORT_VERSION 1
+
+// Also run a throwaway Argon2 pass at the real memlimit (up to 1 GiB).
+// The arena is not kept, so this only makes the kernel reclaim that much
+// memory early; off by default because every launch would pay for it.
+#define WARMUP_FLAG_KDF_ARENA 0x01
+
+typedef struct {
+    uint32_t version;        // WARMUP_REPORT_VERSION
+    int32_t status;          // 0 on success, -1 if sodium_init() failed
+    uint64_t opslimit;       // Argon2id parameters unlocks will use
+    uint64_t memlimit;
+    uint64_t sodium_init_ns; // incl. mapping the secure pool
+    uint64_t kdf_select_ns;
+    uint64_t kdf_arena_ns;   // 0 unless WARMUP_FLAG_KDF_ARENA
+    uint64_t cpu_probe_ns;   // Base64 SIMD level + container AEAD selection
+    uint64_t total_ns;
+} crypto_warmup_report;
+
+typedef void (*crypto_warmup_cb)(const crypto_warmup_report *report);
+
+// Runs the warm-up on the calling thread and copies the timings into
+// [report] (optional). Only the first successful run does any work; later
+// calls, or calls made while the background warm-up is running, wait for
+// it and get the same report. A failed run (status -1) is not kept: the
+// next call tries again. Returns the report status.
+int native_crypto_warmup(uint32_t flags, crypto_warmup_report *report);
+
+// Starts the warm-up on a detached background thread and returns at once.
+// [cb] (optional) is invoked with the report when it completes, from the
+// warm-up thread, or immediately on the calling thread if it already has;
+// the report stays valid for the life of the process (after a failed run
+// it may be overwritten by the retry). Up to four callbacks
+// can be pending. Returns 0, or -1 if the thread could not be started or
+// too many callbacks are queued.
+int native_crypto_warmup_start(uint32_t flags, crypto_warmup_cb cb);
+
 #endif // NATIVE_CRYPTO_H 
\ No newline at end of file
@@ -1,4 +1,9 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // dl_iterate_phdr() on glibc
+#endif
 #include "native_integrity.h"
+#include "native_stats.h"
+#include "sodium.h"
 #include <errno.h>
 #if defined(__ANDROID__) || defined(__linux__)
 #include <sys/ptrace.h>
@@ -9,9 +14,20 @@ static inline long ptrace(int request, ...) { (void)request; errno = EPERM; retu
 #endif
 #include <unistd.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#if defined(__ANDROID__) || defined(__linux__)
+#include <link.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+#if defined(__ANDROID__)
+#include <sys/system_properties.h>
+#endif
 
 #if !defined(PTRACE_TRACEME)
 #define PTRACE_TRACEME 0
@@ -23,7 +39,83 @@ static inline long ptrace(int request, ...) { (void)request; errno = EPERM; retu
 static volatile int _playIntegrityOK = 1; // 1 = passed by default
 void set_play_integrity_status(int ok) { _playIntegrityOK = ok; }
 
-static int _is_debugger_attached() {
+#if defined(__ANDROID__) || defined(__linux__)
+// Returns the TracerPid from /proc/self/status (0 = not traced), or -1 if
+// it cannot be read.
+static long _tracer_pid() {
+    int fd = open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    char buf[2048];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    const char *p = strstr(buf, "TracerPid:");
+    if (!p) return -1;
+    return strtol(p + 10, NULL, 10);
+}
+
+// Streams [path] through a fixed 4 KiB buffer and calls [fn] once per line
+// (without the newline). A line longer than the buffer is delivered
+// truncated to its first 4 KiB. Returns -1 if the file cannot be opened.
+static int _for_each_line(const char *path,
+                          void (*fn)(const char *line, size_t len, void *ctx),
+                          void *ctx) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    char buf[4096];
+    size_t have = 0;
+    int truncated = 0; // inside an over-long line whose head was delivered
+
+    for (;;) {
+        ssize_t n = read(fd, buf + have, sizeof(buf) - have);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            if (have && !truncated) fn(buf, have, ctx);
+            break;
+        }
+        have += (size_t)n;
+
+        char *start = buf;
+        char *nl;
+        while ((nl = memchr(start, '\n', (size_t)(buf + have - start)))) {
+            if (!truncated) fn(start, (size_t)(nl - start), ctx);
+            truncated = 0;
+            start = nl + 1;
+        }
+        have = (size_t)(buf + have - start);
+        memmove(buf, start, have);
+        if (have == sizeof(buf)) {
+            fn(buf, have, ctx);
+            have = 0;
+            truncated = 1;
+        }
+    }
+    close(fd);
+    return 0;
+}
+#endif
+
+/*
+ * Every check has the same shape: it returns non-zero on a hit and may fill
+ * [matched] (index into its path table) and [detail] (check specific, see
+ * integrity_check_report in the header) for the structured report.
+ */
+
+static int _is_debugger_attached(int32_t *matched, int32_t *detail) {
+    (void)matched;
+#if defined(__ANDROID__) || defined(__linux__)
+    // Prefer TracerPid: it has no side effects, whereas a successful
+    // PTRACE_TRACEME makes the parent our tracer and every later probe
+    // would then report a debugger. This check runs on every cache refresh.
+    long tracer = _tracer_pid();
+    if (tracer >= 0) {
+        *detail = (int32_t)tracer;
+        return tracer != 0;
+    }
+#endif
+    *detail = -1;
     // Attempt to ptrace self; if EPERM -> already traced.
     if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == -1) {
         return errno == EPERM;
@@ -37,28 +129,41 @@ static int _file_exists(const char *path) {
     return stat(path, &st) == 0;
 }
 
-static int _has_su_binary() {
-    const char *su_paths[] = {
-        "/system/bin/su", "/system/xbin/su", "/sbin/su",
-        "/vendor/bin/su", "/su/bin/su", NULL};
-    for (int i = 0; su_paths[i]; ++i) {
-        if (_file_exists(su_paths[i])) return 1;
-    }
-    return 0;
-}
+static const char *const _suPaths[] = {
+    "/system/bin/su", "/system/xbin/su", "/sbin/su",
+    "/vendor/bin/su", "/su/bin/su", NULL};
+static const char *const _fridaPaths[] = {
+    "/data/local/tmp/frida-server", "/data/local/frida-server",
+    "/system/bin/frida-server", NULL};
+static const char *const _magiskPaths[] = {
+    "/sbin/.magisk", "/data/adb/magisk", NULL};
+static const char *const _xposedPaths[] = {
+    "/system/bin/app_process64_xposed", "/system/framework/XposedBridge.jar",
+    "/system/lib/libxposed.so", NULL};
 
-static int _frida_server_present() {
-    const char *paths[] = {
-        "/data/local/tmp/frida-server", "/data/local/frida-server",
-        "/system/bin/frida-server", NULL};
+static int _first_present(const char *const *paths, int32_t *matched) {
     for (int i = 0; paths[i]; ++i) {
-        if (_file_exists(paths[i])) return 1;
+        if (_file_exists(paths[i])) {
+            *matched = i;
+            return 1;
+        }
     }
     return 0;
 }
 
+static int _has_su_binary(int32_t *matched, int32_t *detail) {
+    (void)detail;
+    return _first_present(_suPaths, matched);
+}
+
+static int _frida_server_present(int32_t *matched, int32_t *detail) {
+    (void)detail;
+    return _first_present(_fridaPaths, matched);
+}
+
 // Check if SELinux is enforcing (0 = permissive, 1 = enforcing)
-static int _selinux_permissive() {
+static int _selinux_permissive(int32_t *matched, int32_t *detail) {
+    (void)matched; (void)detail;
 #ifdef COMMENT
 /*
  * Returns 1 when the device runs with SELinux set to Permissive mode – a
@@ -79,28 +184,992 @@ static int _selinux_permissive() {
 #endif
 }
 
-static int _magisk_present() {
-    return _file_exists("/sbin/.magisk") || _file_exists("/data/adb/magisk");
+static int _magisk_present(int32_t *matched, int32_t *detail) {
+    (void)detail;
+    return _first_present(_magiskPaths, matched);
 }
 
-static int _xposed_present() {
-    const char *paths[] = {
-        "/system/bin/app_process64_xposed", "/system/framework/XposedBridge.jar",
-        "/system/lib/libxposed.so", NULL};
-    for (int i = 0; paths[i]; ++i) {
-        if (_file_exists(paths[i])) return 1;
-    }
-    return 0;
+static int _xposed_present(int32_t *matched, int32_t *detail) {
+    (void)detail;
+    return _first_present(_xposedPaths, matched);
 }
 
-uint32_t quick_probe_native() {
+static int _hook_in_memory(int32_t *matched, int32_t *detail) {
+    (void)matched;
+    int hits = integrity_scan_maps(NULL);
+    *detail = hits; // INTEGRITY_MAPS_* bits, -1 if maps is unreadable
+    return hits > 0 &&
+           (hits & (INTEGRITY_MAPS_FRIDA | INTEGRITY_MAPS_SUBSTRATE |
+                    INTEGRITY_MAPS_XPOSED | INTEGRITY_MAPS_HOOK_LIB)) != 0;
+}
+
+/* ---------------------------------------------------------------------------
+ *  PROBE CACHE
+ *
+ *  Every check is a row in _checks[] with its own TTL class.  A probe only
+ *  re-runs the rows whose result has expired, so the common case (nothing
+ *  expired) is a clock read plus an uncontended mutex and returns the cached
+ *  bitmask without touching the filesystem or issuing ptrace().
+ * -------------------------------------------------------------------------*/
+
+enum { _TTL_DYNAMIC = 0, _TTL_STATIC = 1 };
+
+typedef struct {
+    uint32_t flag;
+    int (*run)(int32_t *matched, int32_t *detail);
+    int ttl_class;
+    const char *const *paths;
+    // Cached result of the last run
+    int valid;
+    int hit;
+    int32_t matched;
+    int32_t detail;
+    uint64_t checked_ns;
+    uint64_t duration_ns;
+} _integrity_check;
+
+static _integrity_check _checks[] = {
+    {.flag = INTEGRITY_DEBUGGER_ATTACHED, .run = _is_debugger_attached,
+     .ttl_class = _TTL_DYNAMIC},
+    {.flag = INTEGRITY_SU_BINARY_FOUND, .run = _has_su_binary,
+     .ttl_class = _TTL_STATIC, .paths = _suPaths},
+    {.flag = INTEGRITY_FRIDA_DETECTED, .run = _frida_server_present,
+     .ttl_class = _TTL_STATIC, .paths = _fridaPaths},
+    {.flag = INTEGRITY_SELINUX_PERMISSIVE, .run = _selinux_permissive,
+     .ttl_class = _TTL_STATIC},
+    {.flag = INTEGRITY_MAGISK_DETECTED, .run = _magisk_present,
+     .ttl_class = _TTL_STATIC, .paths = _magiskPaths},
+    {.flag = INTEGRITY_XPOSED_DETECTED, .run = _xposed_present,
+     .ttl_class = _TTL_STATIC, .paths = _xposedPaths},
+    // Static TTL: injection arrives through dlopen(), which the monitor
+    // notices via its module count and answers with a full probe.
+    {.flag = INTEGRITY_HOOK_IN_MEMORY, .run = _hook_in_memory,
+     .ttl_class = _TTL_STATIC},
+};
+#define _CHECK_COUNT (sizeof(_checks) / sizeof(_checks[0]))
+
+static pthread_mutex_t _cacheLock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t _ttlNs[2] = {
+    (uint64_t)INTEGRITY_DEFAULT_DYNAMIC_TTL_MS * 1000000ull,
+    (uint64_t)INTEGRITY_DEFAULT_STATIC_TTL_MS * 1000000ull,
+};
+
+static uint64_t _now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Runs expired (or, with [force], all) checks and returns the bitmask. When
+// [report] is given, each row is copied out under the same lock.
+static uint32_t _probe(int force, integrity_report *report) {
     uint32_t flags = 0;
-    if (_is_debugger_attached()) flags |= INTEGRITY_DEBUGGER_ATTACHED;
-    if (_has_su_binary())       flags |= INTEGRITY_SU_BINARY_FOUND;
-    if (_frida_server_present()) flags |= INTEGRITY_FRIDA_DETECTED;
-    if (!_playIntegrityOK)      flags |= INTEGRITY_PLAY_VERDICT_FAIL;
-    if (_selinux_permissive())  flags |= INTEGRITY_SELINUX_PERMISSIVE;
-    if (_magisk_present())      flags |= INTEGRITY_MAGISK_DETECTED;
-    if (_xposed_present())      flags |= INTEGRITY_XPOSED_DETECTED;
+    uint64_t now = _now_ns();
+
+    pthread_mutex_lock(&_cacheLock);
+    for (size_t i = 0; i < _CHECK_COUNT; ++i) {
+        _integrity_check *c = &_checks[i];
+        if (force || !c->valid || now - c->checked_ns >= _ttlNs[c->ttl_class]) {
+            c->matched = -1;
+            c->detail = 0;
+            c->hit = c->run(&c->matched, &c->detail) ? 1 : 0;
+            c->checked_ns = _now_ns();
+            c->duration_ns = c->checked_ns - now;
+            c->valid = 1;
+            now = c->checked_ns;
+        }
+        if (c->hit) flags |= c->flag;
+
+        if (report && i < INTEGRITY_REPORT_MAX_CHECKS) {
+            integrity_check_report *r = &report->checks[i];
+            r->flag = c->flag;
+            r->status = c->hit ? INTEGRITY_CHECK_DETECTED : INTEGRITY_CHECK_CLEAN;
+            r->matched_index = c->matched;
+            r->detail = c->detail;
+            r->duration_ns = c->duration_ns;
+            r->age_ns = now - c->checked_ns;
+        }
+    }
+    pthread_mutex_unlock(&_cacheLock);
+
+    // The Play Integrity verdict is pushed in from Kotlin; reading it is free.
+    if (!_playIntegrityOK) flags |= INTEGRITY_PLAY_VERDICT_FAIL;
     return flags;
-} 
\ No newline at end of file
+}
+
+uint32_t quick_probe_native() {
+    STATS_SCOPE(STATS_FN_QUICK_PROBE, 0);
+    return _probe(0, NULL);
+}
+
+uint32_t full_probe_native() {
+    STATS_SCOPE(STATS_FN_FULL_PROBE, 0);
+    return _probe(1, NULL);
+}
+
+int integrity_report_fill(integrity_report *report, int force) {
+    STATS_SCOPE(STATS_FN_INTEGRITY_REPORT, 0);
+    if (report == NULL) return -1;
+    uint64_t start = _now_ns();
+    memset(report, 0, sizeof(*report));
+    report->version = INTEGRITY_REPORT_VERSION;
+    report->check_count = _CHECK_COUNT < INTEGRITY_REPORT_MAX_CHECKS
+                              ? (uint32_t)_CHECK_COUNT
+                              : INTEGRITY_REPORT_MAX_CHECKS;
+    report->flags = _probe(force, report);
+    report->probe_ns = _now_ns() - start;
+    return (int)report->check_count;
+}
+
+const char *integrity_check_path(uint32_t flag, int32_t index) {
+    if (index < 0) return NULL;
+    for (size_t i = 0; i < _CHECK_COUNT; ++i) {
+        if (_checks[i].flag != flag || _checks[i].paths == NULL) continue;
+        for (int32_t j = 0; _checks[i].paths[j]; ++j) {
+            if (j == index) return _checks[i].paths[j];
+        }
+    }
+    return NULL;
+}
+
+void integrity_set_cache_ttl(uint32_t dynamic_ms, uint32_t static_ms) {
+    pthread_mutex_lock(&_cacheLock);
+    _ttlNs[_TTL_DYNAMIC] = (uint64_t)dynamic_ms * 1000000ull;
+    _ttlNs[_TTL_STATIC] = (uint64_t)static_ms * 1000000ull;
+    pthread_mutex_unlock(&_cacheLock);
+}
+
+void integrity_invalidate_cache() {
+    pthread_mutex_lock(&_cacheLock);
+    for (size_t i = 0; i < _CHECK_COUNT; ++i) _checks[i].valid = 0;
+    pthread_mutex_unlock(&_cacheLock);
+}
+
+/* ---------------------------------------------------------------------------
+ *  BATCHED PATH PROBE
+ *
+ *  Dart used to await File.exists() once per indicator – each one a hop
+ *  through the IO thread pool. Here the whole table is stat'ed in one FFI
+ *  call. fstatat(AT_SYMLINK_NOFOLLOW) sees directories and dangling links
+ *  too, which File.exists() silently reported as absent.
+ * -------------------------------------------------------------------------*/
+
+int integrity_probe_paths(const char *const *paths, size_t count,
+                          uint8_t *results) {
+    STATS_SCOPE(STATS_FN_PROBE_PATHS, count);
+    if ((paths == NULL || results == NULL) && count != 0) return -1;
+
+    int present = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t r = 0;
+        struct stat st;
+        if (paths[i] != NULL &&
+            fstatat(AT_FDCWD, paths[i], &st, AT_SYMLINK_NOFOLLOW) == 0) {
+            r |= INTEGRITY_PATH_PRESENT;
+            if (S_ISDIR(st.st_mode)) r |= INTEGRITY_PATH_DIRECTORY;
+            if (faccessat(AT_FDCWD, paths[i], X_OK, 0) == 0 &&
+                !S_ISDIR(st.st_mode)) {
+                r |= INTEGRITY_PATH_EXECUTABLE;
+            }
+            ++present;
+        } else if (paths[i] != NULL && errno == EACCES) {
+            r |= INTEGRITY_PATH_DENIED;
+        }
+        results[i] = r;
+    }
+    return present;
+}
+
+/* ---------------------------------------------------------------------------
+ *  MEMORY MAP SCANNER
+ *
+ *  /proc/self/maps is read through a fixed 4 KiB buffer – no allocation, no
+ *  stdio – and each mapped path is fed through an Aho-Corasick DFA built
+ *  once from _mapSignatures[], so all signatures cost a single pass over
+ *  the text. Input is folded to a 40-symbol alphabet (letters
+ *  case-insensitive, digits, '-', '_', '.', everything else) which keeps
+ *  the transition table at 20 KiB.
+ * -------------------------------------------------------------------------*/
+
+static const struct {
+    const char *pattern;
+    uint32_t hit;
+} _mapSignatures[] = {
+    {"frida",     INTEGRITY_MAPS_FRIDA},
+    {"gum-js",    INTEGRITY_MAPS_FRIDA},
+    {"linjector", INTEGRITY_MAPS_FRIDA},
+    {"substrate", INTEGRITY_MAPS_SUBSTRATE},
+    {"xposed",    INTEGRITY_MAPS_XPOSED},
+    {"edxp",      INTEGRITY_MAPS_XPOSED},
+    {"liblspd",   INTEGRITY_MAPS_XPOSED},
+    {"libriru",   INTEGRITY_MAPS_XPOSED},
+    {"sandhook",  INTEGRITY_MAPS_HOOK_LIB},
+    {"libwhale",  INTEGRITY_MAPS_HOOK_LIB},
+    {"dobby",     INTEGRITY_MAPS_HOOK_LIB},
+    {"magisk",    INTEGRITY_MAPS_MAGISK},
+    {"zygisk",    INTEGRITY_MAPS_MAGISK},
+};
+#define _SIGNATURE_COUNT (sizeof(_mapSignatures) / sizeof(_mapSignatures[0]))
+
+#define _AC_CLASSES    40
+#define _AC_MAX_STATES 256
+
+static uint16_t _acGoto[_AC_MAX_STATES][_AC_CLASSES];
+static uint32_t _acOut[_AC_MAX_STATES];
+static pthread_once_t _acOnce = PTHREAD_ONCE_INIT;
+
+static inline int _ac_class(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') c = (unsigned char)(c + 32);
+    if (c >= 'a' && c <= 'z') return 1 + (c - 'a');
+    if (c >= '0' && c <= '9') return 27 + (c - '0');
+    if (c == '-') return 37;
+    if (c == '_') return 38;
+    if (c == '.') return 39;
+    return 0;
+}
+
+static void _ac_build() {
+    uint16_t fail[_AC_MAX_STATES];
+    uint16_t queue[_AC_MAX_STATES];
+    int states = 1;
+
+    // Trie; 0 in _acGoto means "no edge" until the DFA is completed below.
+    for (size_t i = 0; i < _SIGNATURE_COUNT; ++i) {
+        int s = 0;
+        for (const char *p = _mapSignatures[i].pattern; *p; ++p) {
+            int c = _ac_class((unsigned char)*p);
+            if (_acGoto[s][c] == 0) _acGoto[s][c] = (uint16_t)states++;
+            s = _acGoto[s][c];
+        }
+        _acOut[s] |= _mapSignatures[i].hit;
+    }
+
+    // BFS: fail links, output propagation and full DFA transitions.
+    int head = 0, tail = 0;
+    for (int c = 0; c < _AC_CLASSES; ++c) {
+        uint16_t t = _acGoto[0][c];
+        if (t) {
+            fail[t] = 0;
+            queue[tail++] = t;
+        }
+    }
+    while (head < tail) {
+        uint16_t s = queue[head++];
+        _acOut[s] |= _acOut[fail[s]];
+        for (int c = 0; c < _AC_CLASSES; ++c) {
+            uint16_t t = _acGoto[s][c];
+            if (t) {
+                fail[t] = _acGoto[fail[s]][c];
+                queue[tail++] = t;
+            } else {
+                _acGoto[s][c] = _acGoto[fail[s]][c];
+            }
+        }
+    }
+}
+
+static uint32_t _ac_match(const char *text, size_t len) {
+    uint32_t hits = 0;
+    uint16_t s = 0;
+    for (size_t i = 0; i < len; ++i) {
+        s = _acGoto[s][_ac_class((unsigned char)text[i])];
+        hits |= _acOut[s];
+    }
+    return hits;
+}
+
+typedef struct {
+    uint32_t hits;
+    uint32_t rwx;
+} _maps_scan;
+
+// One maps line: "start-end perms offset dev inode   pathname".
+static void _scan_maps_line(const char *line, size_t len, void *ctx) {
+    _maps_scan *scan = (_maps_scan *)ctx;
+    const char *end = line + len;
+    const char *p = line;
+    const char *perms = NULL;
+
+    for (int field = 0; field < 5 && p < end; ++field) {
+        while (p < end && *p != ' ') ++p;
+        while (p < end && *p == ' ') ++p;
+        if (field == 0) perms = p;
+    }
+    const char *path = p;
+    size_t path_len = (size_t)(end - path);
+
+    // Only unnamed RWX mappings count. Runtimes name theirs: ART's JIT
+    // code cache is /memfd:jit-cache and allocators tag [anon:...] regions,
+    // while injected trampolines come from a bare mmap().
+    if (perms != NULL && perms + 3 <= end &&
+        perms[0] == 'r' && perms[1] == 'w' && perms[2] == 'x' &&
+        path_len == 0) {
+        ++scan->rwx;
+    }
+    if (path_len) scan->hits |= _ac_match(path, path_len);
+}
+
+int integrity_scan_maps(uint32_t *rwx_regions) {
+    STATS_SCOPE(STATS_FN_SCAN_MAPS, 0);
+#if defined(__ANDROID__) || defined(__linux__)
+    pthread_once(&_acOnce, _ac_build);
+
+    _maps_scan scan = {0, 0};
+    if (_for_each_line("/proc/self/maps", _scan_maps_line, &scan) != 0) {
+        return -1;
+    }
+
+    if (scan.rwx) scan.hits |= INTEGRITY_MAPS_ANON_RWX;
+    if (rwx_regions) *rwx_regions = scan.rwx;
+    return (int)scan.hits;
+#else
+    if (rwx_regions) *rwx_regions = 0;
+    return -1;
+#endif
+}
+
+/* ---------------------------------------------------------------------------
+ *  CODE-SECTION SELF-CHECKSUM
+ *
+ *  The baseline hashes every 4 KiB page of a module's executable segments
+ *  into a 16-byte BLAKE2b leaf; the module digest is BLAKE2b-256 over the
+ *  leaves. Text carries no relocations in PIC builds, so the digest is
+ *  stable across launches and changes only when the binary is patched.
+ *  Verification re-hashes a random sample of pages against the leaves, so a
+ *  runtime check costs a few microseconds instead of a multi-MB rehash.
+ * -------------------------------------------------------------------------*/
+
+#define _TEXT_MAX_MODULES  4
+#define _TEXT_MAX_SEGMENTS 4
+#define _TEXT_LEAF_BYTES   16
+
+typedef struct {
+    char name[64];
+    int nseg;
+    const uint8_t *seg_start[_TEXT_MAX_SEGMENTS];
+    size_t seg_len[_TEXT_MAX_SEGMENTS];
+    size_t seg_first_page[_TEXT_MAX_SEGMENTS];
+    size_t pages;
+    uint8_t (*leaves)[_TEXT_LEAF_BYTES];
+    uint8_t digest[INTEGRITY_TEXT_DIGEST_BYTES];
+    int valid;
+} _text_module;
+
+static _text_module _textModules[_TEXT_MAX_MODULES];
+static pthread_mutex_t _textLock = PTHREAD_MUTEX_INITIALIZER;
+
+static _text_module *_text_slot(const char *module, int create) {
+    _text_module *free_slot = NULL;
+    for (int i = 0; i < _TEXT_MAX_MODULES; ++i) {
+        _text_module *m = &_textModules[i];
+        if (m->name[0] == '\0') {
+            if (!free_slot) free_slot = m;
+        } else if (strcmp(m->name, module) == 0) {
+            return m;
+        }
+    }
+    if (!create || !free_slot) return NULL;
+    snprintf(free_slot->name, sizeof(free_slot->name), "%s", module);
+    return free_slot;
+}
+
+static void _text_leaf(const _text_module *m, size_t page, uint8_t *leaf) {
+    int seg = m->nseg - 1;
+    while (seg > 0 && m->seg_first_page[seg] > page) --seg;
+    size_t off = (page - m->seg_first_page[seg]) * INTEGRITY_TEXT_PAGE_BYTES;
+    size_t len = m->seg_len[seg] - off;
+    if (len > INTEGRITY_TEXT_PAGE_BYTES) len = INTEGRITY_TEXT_PAGE_BYTES;
+    crypto_generichash(leaf, _TEXT_LEAF_BYTES, m->seg_start[seg] + off, len,
+                       NULL, 0);
+}
+
+#if defined(__ANDROID__) || defined(__linux__)
+typedef struct {
+    const char *module;
+    _text_module *m;
+    int found;
+} _text_locate;
+
+static int _text_locate_cb(struct dl_phdr_info *info, size_t size,
+                           void *data) {
+    (void)size;
+    _text_locate *loc = (_text_locate *)data;
+    const char *path = info->dlpi_name;
+    if (path == NULL || path[0] == '\0') return 0;
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    if (strcmp(base, loc->module) != 0) return 0;
+
+    _text_module *m = loc->m;
+    m->nseg = 0;
+    for (int i = 0; i < info->dlpi_phnum && m->nseg < _TEXT_MAX_SEGMENTS; ++i) {
+        const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+        if (ph->p_type != PT_LOAD || !(ph->p_flags & PF_X) || ph->p_filesz == 0)
+            continue;
+        m->seg_start[m->nseg] = (const uint8_t *)(info->dlpi_addr + ph->p_vaddr);
+        m->seg_len[m->nseg] = ph->p_filesz;
+        ++m->nseg;
+    }
+    loc->found = m->nseg > 0;
+    return 1; // stop iterating
+}
+#endif
+
+int64_t integrity_text_baseline(const char *module, uint8_t *digest,
+                                size_t digest_len, int refresh) {
+#if defined(__ANDROID__) || defined(__linux__)
+    if (module == NULL || digest == NULL ||
+        digest_len < INTEGRITY_TEXT_DIGEST_BYTES) {
+        return -1;
+    }
+    if (sodium_init() < 0) return -1;
+
+    pthread_mutex_lock(&_textLock);
+    _text_module *m = _text_slot(module, 1);
+    if (m == NULL) {
+        pthread_mutex_unlock(&_textLock);
+        return -1;
+    }
+
+    if (!m->valid || refresh) {
+        // Only record segment ranges under the loader lock; hash after.
+        _text_locate loc = {module, m, 0};
+        dl_iterate_phdr(_text_locate_cb, &loc);
+        if (!loc.found) {
+            m->name[0] = '\0';
+            m->valid = 0;
+            pthread_mutex_unlock(&_textLock);
+            return -1;
+        }
+
+        size_t pages = 0;
+        for (int i = 0; i < m->nseg; ++i) {
+            m->seg_first_page[i] = pages;
+            pages += (m->seg_len[i] + INTEGRITY_TEXT_PAGE_BYTES - 1) /
+                     INTEGRITY_TEXT_PAGE_BYTES;
+        }
+        uint8_t (*leaves)[_TEXT_LEAF_BYTES] =
+            realloc(m->leaves, pages * _TEXT_LEAF_BYTES);
+        if (leaves == NULL) {
+            m->valid = 0;
+            pthread_mutex_unlock(&_textLock);
+            return -1;
+        }
+        m->leaves = leaves;
+        m->pages = pages;
+
+        crypto_generichash_state st;
+        crypto_generichash_init(&st, NULL, 0, INTEGRITY_TEXT_DIGEST_BYTES);
+        for (size_t p = 0; p < pages; ++p) {
+            _text_leaf(m, p, m->leaves[p]);
+            crypto_generichash_update(&st, m->leaves[p], _TEXT_LEAF_BYTES);
+        }
+        crypto_generichash_final(&st, m->digest, INTEGRITY_TEXT_DIGEST_BYTES);
+        m->valid = 1;
+    }
+
+    int64_t covered = 0;
+    for (int i = 0; i < m->nseg; ++i) covered += (int64_t)m->seg_len[i];
+    memcpy(digest, m->digest, INTEGRITY_TEXT_DIGEST_BYTES);
+    pthread_mutex_unlock(&_textLock);
+    return covered;
+#else
+    (void)module; (void)digest; (void)digest_len; (void)refresh;
+    return -1;
+#endif
+}
+
+int integrity_text_verify(const char *module, uint32_t pages) {
+    if (module == NULL) return -1;
+
+    pthread_mutex_lock(&_textLock);
+    _text_module *m = _text_slot(module, 0);
+    if (m == NULL || !m->valid) {
+        pthread_mutex_unlock(&_textLock);
+        return -1;
+    }
+
+    int mismatch = 0;
+    uint8_t leaf[_TEXT_LEAF_BYTES];
+    if (pages == 0 || pages >= m->pages) {
+        for (size_t p = 0; p < m->pages; ++p) {
+            _text_leaf(m, p, leaf);
+            mismatch |= sodium_memcmp(leaf, m->leaves[p], _TEXT_LEAF_BYTES);
+        }
+    } else {
+        for (uint32_t i = 0; i < pages; ++i) {
+            size_t p = randombytes_uniform((uint32_t)m->pages);
+            _text_leaf(m, p, leaf);
+            mismatch |= sodium_memcmp(leaf, m->leaves[p], _TEXT_LEAF_BYTES);
+        }
+    }
+    pthread_mutex_unlock(&_textLock);
+    return mismatch ? 1 : 0;
+}
+
+/* ---------------------------------------------------------------------------
+ *  LIBRARY SELF-CHECK
+ *
+ *  Replaces reading the whole .so from disk and hashing it in Dart: the
+ *  mapped read-only segments are already in memory, and hashing them
+ *  natively takes about a millisecond. The segments are located through
+ *  the address of a function in this file, so no library path is needed.
+ *  Writable segments (.data, GOT, RELRO) are skipped because relocation
+ *  changes them on every load.
+ * -------------------------------------------------------------------------*/
+
+#define _SELF_MAX_SEGMENTS 8
+
+#if defined(__ANDROID__) || defined(__linux__)
+typedef struct {
+    uintptr_t anchor;
+    int nseg;
+    const uint8_t *start[_SELF_MAX_SEGMENTS];
+    uint64_t vaddr[_SELF_MAX_SEGMENTS];
+    size_t len[_SELF_MAX_SEGMENTS];
+} _self_locate;
+
+static int _self_locate_cb(struct dl_phdr_info *info, size_t size, void *data) {
+    (void)size;
+    _self_locate *loc = (_self_locate *)data;
+    int ours = 0;
+    for (int i = 0; i < info->dlpi_phnum; ++i) {
+        const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+        uintptr_t lo = info->dlpi_addr + ph->p_vaddr;
+        if (ph->p_type == PT_LOAD && loc->anchor >= lo &&
+            loc->anchor < lo + ph->p_memsz) {
+            ours = 1;
+            break;
+        }
+    }
+    if (!ours) return 0;
+
+    for (int i = 0; i < info->dlpi_phnum && loc->nseg < _SELF_MAX_SEGMENTS; ++i) {
+        const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+        if (ph->p_type != PT_LOAD || (ph->p_flags & PF_W) || ph->p_filesz == 0)
+            continue;
+        loc->start[loc->nseg] = (const uint8_t *)(info->dlpi_addr + ph->p_vaddr);
+        loc->vaddr[loc->nseg] = ph->p_vaddr;
+        loc->len[loc->nseg] = ph->p_filesz;
+        ++loc->nseg;
+    }
+    return 1;
+}
+#endif
+
+int64_t integrity_self_digest(uint8_t *digest, size_t digest_len) {
+    STATS_SCOPE(STATS_FN_SELF_DIGEST, 0);
+#if defined(__ANDROID__) || defined(__linux__)
+    if (digest == NULL || digest_len < INTEGRITY_SELF_DIGEST_BYTES) return -1;
+    if (sodium_init() < 0) return -1;
+
+    // Record ranges under the loader lock, hash after it is released.
+    _self_locate loc = {.anchor = (uintptr_t)&integrity_self_digest};
+    dl_iterate_phdr(_self_locate_cb, &loc);
+    if (loc.nseg == 0) return -1;
+
+    crypto_generichash_state st;
+    crypto_generichash_init(&st, NULL, 0, INTEGRITY_SELF_DIGEST_BYTES);
+    int64_t covered = 0;
+    for (int i = 0; i < loc.nseg; ++i) {
+        // Frame each segment with its link-time address and size.
+        uint64_t frame[2] = {loc.vaddr[i], (uint64_t)loc.len[i]};
+        crypto_generichash_update(&st, (const uint8_t *)frame, sizeof frame);
+        crypto_generichash_update(&st, loc.start[i], loc.len[i]);
+        covered += (int64_t)loc.len[i];
+    }
+    crypto_generichash_final(&st, digest, INTEGRITY_SELF_DIGEST_BYTES);
+    return covered;
+#else
+    (void)digest; (void)digest_len;
+    return -1;
+#endif
+}
+
+// One block per check. The digest comes first so the pointer handed to the
+// callback is the block itself and integrity_self_check_free() can take it.
+typedef struct {
+    uint8_t digest[INTEGRITY_SELF_DIGEST_BYTES];
+    integrity_self_cb cb;
+} _self_job;
+
+static void *_self_check_thread(void *arg) {
+    _self_job *job = arg;
+
+    uint64_t start = _now_ns();
+    int64_t covered = integrity_self_digest(job->digest, sizeof job->digest);
+    uint64_t elapsed = _now_ns() - start;
+
+    job->cb(covered, job->digest, elapsed); // the receiver frees the block
+    return NULL;
+}
+
+int integrity_self_check_async(integrity_self_cb cb) {
+    if (cb == NULL) return -1;
+
+    _self_job *job = calloc(1, sizeof *job);
+    pthread_attr_t attr;
+    pthread_t tid;
+    int ok = job != NULL && pthread_attr_init(&attr) == 0;
+    if (ok) {
+        job->cb = cb;
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        ok = pthread_create(&tid, &attr, _self_check_thread, job) == 0;
+        pthread_attr_destroy(&attr);
+    }
+    if (!ok) {
+        free(job);
+        return -1;
+    }
+    return 0;
+}
+
+void integrity_self_check_free(const uint8_t *digest) {
+    free((void *)digest);
+}
+
+/* ---------------------------------------------------------------------------
+ *  DEVICE DNA
+ *
+ *  Each source is framed as label, LE32 length, value, so an absent source
+ *  cannot collide with a present one. Only fields that survive reboots, OS
+ *  updates and CPU hotplug are used: cpuinfo lines are filtered to identity
+ *  keys and de-duplicated (offline cores drop out of /proc/cpuinfo), memory
+ *  is rounded to 512 MiB, and build fingerprints are deliberately skipped.
+ * -------------------------------------------------------------------------*/
+
+#define _DNA_VALUE_MAX   256
+#define _DNA_CPU_LINES   32
+#define _DNA_CPU_LINE    96
+
+static void _dna_absorb(crypto_generichash_state *st, const char *label,
+                        const char *value, size_t len) {
+    uint8_t le[4];
+    uint32_t n = value ? (uint32_t)len : 0xFFFFFFFFu;
+    le[0] = (uint8_t)n;
+    le[1] = (uint8_t)(n >> 8);
+    le[2] = (uint8_t)(n >> 16);
+    le[3] = (uint8_t)(n >> 24);
+    crypto_generichash_update(st, (const uint8_t *)label, strlen(label) + 1);
+    crypto_generichash_update(st, le, sizeof le);
+    if (value && len) crypto_generichash_update(st, (const uint8_t *)value, len);
+}
+
+#if defined(__ANDROID__) || defined(__linux__)
+static void _dna_absorb_file(crypto_generichash_state *st, const char *path) {
+    char buf[_DNA_VALUE_MAX];
+    ssize_t n = -1;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        do {
+            n = read(fd, buf, sizeof buf);
+        } while (n < 0 && errno == EINTR);
+        close(fd);
+    }
+    if (n < 0) {
+        _dna_absorb(st, path, NULL, 0);
+        return;
+    }
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ' ||
+                     buf[n - 1] == '\0')) {
+        --n;
+    }
+    _dna_absorb(st, path, buf, (size_t)n);
+}
+
+typedef struct {
+    char lines[_DNA_CPU_LINES][_DNA_CPU_LINE];
+    int count;
+} _dna_cpuinfo;
+
+static const char *const _cpuIdentityKeys[] = {
+    "CPU implementer", "CPU architecture", "CPU variant", "CPU part",
+    "CPU revision", "Hardware", "model name", "vendor_id", "cpu family",
+    "model\t", "stepping", NULL};
+
+static void _dna_cpuinfo_line(const char *line, size_t len, void *ctx) {
+    _dna_cpuinfo *ci = (_dna_cpuinfo *)ctx;
+    int keep = 0;
+    for (int i = 0; _cpuIdentityKeys[i]; ++i) {
+        size_t k = strlen(_cpuIdentityKeys[i]);
+        if (len >= k && memcmp(line, _cpuIdentityKeys[i], k) == 0) {
+            keep = 1;
+            break;
+        }
+    }
+    if (!keep) return;
+    if (len >= _DNA_CPU_LINE) len = _DNA_CPU_LINE - 1;
+
+    char tmp[_DNA_CPU_LINE];
+    memcpy(tmp, line, len);
+    tmp[len] = '\0';
+
+    // Sorted insert without duplicates: order of cores must not matter.
+    int pos = 0;
+    while (pos < ci->count) {
+        int c = strcmp(ci->lines[pos], tmp);
+        if (c == 0) return;
+        if (c > 0) break;
+        ++pos;
+    }
+    if (ci->count == _DNA_CPU_LINES) return;
+    memmove(ci->lines[pos + 1], ci->lines[pos],
+            (size_t)(ci->count - pos) * _DNA_CPU_LINE);
+    memcpy(ci->lines[pos], tmp, len + 1);
+    ++ci->count;
+}
+#endif
+
+#if defined(__ANDROID__)
+static const char *const _boardProps[] = {
+    "ro.product.board", "ro.board.platform", "ro.hardware",
+    "ro.boot.hardware", "ro.product.manufacturer", "ro.product.model",
+    "ro.product.device", "ro.soc.manufacturer", "ro.soc.model", NULL};
+#elif defined(__linux__)
+static const char *const _dmiFiles[] = {
+    "/sys/class/dmi/id/sys_vendor", "/sys/class/dmi/id/product_name",
+    "/sys/class/dmi/id/board_vendor", "/sys/class/dmi/id/board_name",
+    "/etc/machine-id", NULL};
+#endif
+
+static const char *const _socFiles[] = {
+    "/sys/devices/soc0/machine", "/sys/devices/soc0/family",
+    "/sys/devices/soc0/soc_id", "/sys/devices/soc0/revision",
+    "/sys/devices/soc0/vendor", "/sys/devices/soc0/serial_number", NULL};
+
+int device_fingerprint(const uint8_t *context, size_t context_len,
+                       uint8_t *out, size_t out_len) {
+    if (out == NULL || out_len < crypto_generichash_BYTES_MIN ||
+        out_len > crypto_generichash_BYTES_MAX ||
+        (context == NULL && context_len != 0)) {
+        return -1;
+    }
+    if (sodium_init() < 0) return -1;
+
+    crypto_generichash_state st;
+    crypto_generichash_init(&st, NULL, 0, out_len);
+    _dna_absorb(&st, "notehider.device_dna.v1", "", 0);
+    _dna_absorb(&st, "context", context ? (const char *)context : "",
+                context_len);
+
+#if defined(__ANDROID__) || defined(__linux__)
+    _dna_cpuinfo ci;
+    ci.count = 0;
+    _for_each_line("/proc/cpuinfo", _dna_cpuinfo_line, &ci);
+    for (int i = 0; i < ci.count; ++i) {
+        _dna_absorb(&st, "cpuinfo", ci.lines[i], strlen(ci.lines[i]));
+    }
+
+    for (int i = 0; _socFiles[i]; ++i) _dna_absorb_file(&st, _socFiles[i]);
+#endif
+
+#if defined(__ANDROID__)
+    for (int i = 0; _boardProps[i]; ++i) {
+        char value[PROP_VALUE_MAX];
+        int n = __system_property_get(_boardProps[i], value);
+        _dna_absorb(&st, _boardProps[i], n > 0 ? value : NULL,
+                    n > 0 ? (size_t)n : 0);
+    }
+#elif defined(__linux__)
+    for (int i = 0; _dmiFiles[i]; ++i) _dna_absorb_file(&st, _dmiFiles[i]);
+#endif
+
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) {
+        const uint64_t step = 512ull << 20;
+        uint64_t mem = (uint64_t)pages * (uint64_t)page_size;
+        char mem_str[24];
+        int n = snprintf(mem_str, sizeof mem_str, "%llu",
+                         (unsigned long long)((mem + step / 2) / step));
+        _dna_absorb(&st, "mem_512m", mem_str, (size_t)n);
+    } else {
+        _dna_absorb(&st, "mem_512m", NULL, 0);
+    }
+
+    crypto_generichash_final(&st, out, out_len);
+    sodium_memzero(&st, sizeof st);
+    return (int)out_len;
+}
+
+/* ---------------------------------------------------------------------------
+ *  BACKGROUND MONITOR
+ *
+ *  Instead of Dart polling on the UI isolate, one native thread sleeps in
+ *  poll(2) on an inotify descriptor (sentinel directories) and a stop pipe.
+ *  Each wake-up – event or [poll_ms] timeout – costs one /proc read for
+ *  TracerPid plus a dl_iterate_phdr() walk, and Dart is only called when the
+ *  bitmask actually changes.
+ * -------------------------------------------------------------------------*/
+
+#if defined(__ANDROID__) || defined(__linux__)
+
+static const char *_sentinel_dirs[] = {
+    "/system/bin", "/system/xbin", "/sbin", "/vendor/bin", "/su/bin",
+    "/data/local/tmp", "/data/local", "/data/adb",
+    "/system/framework", "/system/lib", NULL};
+
+static pthread_mutex_t _monitorLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t _monitorThread;
+static int _monitorRunning = 0;
+static int _monitorStopping = 0; // stop is joining the old thread
+static int _monitorStopPipe[2] = {-1, -1};
+static integrity_event_cb _monitorCb = NULL;
+static uint32_t _monitorPollMs = 0;
+
+// FNV-1a over every module's path and load address. A count alone misses a
+// library swapped for another (one unloaded, one loaded between polls).
+static void _fnv1a(uint64_t *h, const void *p, size_t n) {
+    const unsigned char *b = p;
+    for (size_t i = 0; i < n; ++i) {
+        *h ^= b[i];
+        *h *= 0x100000001b3ull;
+    }
+}
+
+static int _hash_module(struct dl_phdr_info *info, size_t size, void *data) {
+    (void)size;
+    const char *name = info->dlpi_name ? info->dlpi_name : "";
+    _fnv1a(data, name, strlen(name) + 1);
+    _fnv1a(data, &info->dlpi_addr, sizeof info->dlpi_addr);
+    return 0;
+}
+
+static uint64_t _loaded_modules_hash() {
+    uint64_t h = 0xcbf29ce484222325ull;
+    dl_iterate_phdr(_hash_module, &h);
+    return h;
+}
+
+static void *_monitor_main(void *arg) {
+    (void)arg;
+    int ino = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (ino >= 0) {
+        for (int i = 0; _sentinel_dirs[i]; ++i) {
+            // Most of these are absent or unreadable on a stock device; a
+            // failed watch simply leaves that directory to the TTL refresh.
+            inotify_add_watch(ino, _sentinel_dirs[i],
+                              IN_CREATE | IN_DELETE | IN_MOVED_TO |
+                              IN_MOVED_FROM | IN_ATTRIB);
+        }
+    }
+
+    long last_tracer = _tracer_pid();
+    uint64_t last_modules = _loaded_modules_hash();
+    uint32_t last = quick_probe_native();
+    _monitorCb(last, last);
+
+    struct pollfd fds[2];
+    fds[0].fd = _monitorStopPipe[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = ino;
+    fds[1].events = POLLIN;
+
+    for (;;) {
+        int rc = poll(fds, ino >= 0 ? 2 : 1, (int)_monitorPollMs);
+        if (rc < 0 && errno != EINTR) break;
+        if (fds[0].revents) break; // stop requested
+
+        int refresh = 0;
+        if (ino >= 0 && (fds[1].revents & POLLIN)) {
+            char buf[4096];
+            while (read(ino, buf, sizeof buf) > 0) {}
+            refresh = 1;
+        }
+        long tracer = _tracer_pid();
+        if (tracer != last_tracer) {
+            last_tracer = tracer;
+            refresh = 1;
+        }
+        uint64_t modules = _loaded_modules_hash();
+        if (modules != last_modules) {
+            last_modules = modules;
+            refresh = 1;
+        }
+
+        uint32_t flags = refresh ? full_probe_native() : quick_probe_native();
+        if (flags != last) {
+            _monitorCb(flags, flags ^ last);
+            last = flags;
+        }
+    }
+
+    if (ino >= 0) close(ino);
+    return NULL;
+}
+
+int integrity_monitor_start(integrity_event_cb cb, uint32_t poll_ms) {
+    if (cb == NULL) return -1;
+    pthread_mutex_lock(&_monitorLock);
+    if (_monitorRunning || _monitorStopping) {
+        pthread_mutex_unlock(&_monitorLock);
+        return -1;
+    }
+    if (pipe(_monitorStopPipe) != 0) {
+        pthread_mutex_unlock(&_monitorLock);
+        return -1;
+    }
+    _monitorCb = cb;
+    _monitorPollMs = poll_ms < 50 ? 50 : poll_ms;
+    if (pthread_create(&_monitorThread, NULL, _monitor_main, NULL) != 0) {
+        close(_monitorStopPipe[0]);
+        close(_monitorStopPipe[1]);
+        _monitorStopPipe[0] = _monitorStopPipe[1] = -1;
+        pthread_mutex_unlock(&_monitorLock);
+        return -1;
+    }
+    _monitorRunning = 1;
+    pthread_mutex_unlock(&_monitorLock);
+    return 0;
+}
+
+// The join happens outside _monitorLock: the callback may call back into
+// integrity_monitor_running(), and holding the lock would deadlock it.
+// _monitorStopping keeps a concurrent start out until the old thread is
+// gone, since that thread still reads _monitorCb and the stop pipe.
+void integrity_monitor_stop() {
+    pthread_mutex_lock(&_monitorLock);
+    if (!_monitorRunning) {
+        pthread_mutex_unlock(&_monitorLock);
+        return;
+    }
+    pthread_t thread = _monitorThread;
+    int stop_rd = _monitorStopPipe[0];
+    int stop_wr = _monitorStopPipe[1];
+    _monitorRunning = 0;
+    _monitorStopping = 1;
+    pthread_mutex_unlock(&_monitorLock);
+
+    char c = 1;
+    ssize_t w = write(stop_wr, &c, 1);
+    (void)w;
+    pthread_join(thread, NULL);
+    close(stop_rd);
+    close(stop_wr);
+
+    pthread_mutex_lock(&_monitorLock);
+    _monitorStopPipe[0] = _monitorStopPipe[1] = -1;
+    _monitorCb = NULL;
+    _monitorStopping = 0;
+    pthread_mutex_unlock(&_monitorLock);
+}
+
+int integrity_monitor_running() {
+    pthread_mutex_lock(&_monitorLock);
+    int running = _monitorRunning;
+    pthread_mutex_unlock(&_monitorLock);
+    return running;
+}
+
+#else
+
+int integrity_monitor_start(integrity_event_cb cb, uint32_t poll_ms) {
+    (void)cb; (void)poll_ms;
+    return -1; // No inotify / procfs: Dart keeps polling quick_probe_native().
+}
+
+void integrity_monitor_stop() {}
+
+int integrity_monitor_running() { return 0; }
+
+#endif
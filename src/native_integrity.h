@@ -1,6 +1,7 @@
 // native_integrity.h
 #ifndef NATIVE_INTEGRITY_H
 #define NATIVE_INTEGRITY_H
+#include <stddef.h>
 #include <stdint.h>
 
 // Bit-flags returned by quick_probe_native()
@@ -12,9 +13,11 @@
 #define INTEGRITY_SELINUX_PERMISSIVE   0x10
 #define INTEGRITY_MAGISK_DETECTED     0x20
 #define INTEGRITY_XPOSED_DETECTED     0x40
+#define INTEGRITY_HOOK_IN_MEMORY      0x80
 // 0x10  SELinux is in permissive mode (enforcing expected)
 // 0x20  Magisk systemless root or its mountpoints detected
 // 0x40  Xposed / LSPosed or similar hooking framework detected
+// 0x80  A hooking framework is mapped into this process (/proc/self/maps)
 // Add more flags as needed.
 
 #ifdef __cplusplus
@@ -22,11 +25,163 @@ extern "C" {
 #endif
 
 // Returns a bitmask whose non-zero bits indicate integrity violations.
+// Results come from the probe cache: each check is only re-run once its TTL
+// has expired, so repeated calls are cheap (a clock read + mutex).
 uint32_t quick_probe_native();
 
+// Re-runs every check regardless of cache age and refreshes the cache.
+uint32_t full_probe_native();
+
 // Kotlin/Java layer should call this with 1 = passed, 0 = failed
 void set_play_integrity_status(int ok);
 
+// Cache TTLs in milliseconds. "Dynamic" checks observe state that can change
+// at any moment (debugger attach); "static" checks look at on-disk facts
+// (su binaries, Magisk/Xposed/Frida paths, SELinux mode) that only change
+// across reboots or installs. 0 disables caching for that class.
+#define INTEGRITY_DEFAULT_DYNAMIC_TTL_MS 500
+#define INTEGRITY_DEFAULT_STATIC_TTL_MS  30000
+void integrity_set_cache_ttl(uint32_t dynamic_ms, uint32_t static_ms);
+
+// Drops all cached results; the next quick_probe_native() re-runs everything.
+void integrity_invalidate_cache();
+
+// --- Structured report ------------------------------------------------------
+// Fixed layout shared with Dart (ffi.Struct); bump the version on change.
+#define INTEGRITY_REPORT_VERSION    1
+#define INTEGRITY_REPORT_MAX_CHECKS 16
+
+#define INTEGRITY_CHECK_CLEAN     0
+#define INTEGRITY_CHECK_DETECTED  1
+
+typedef struct {
+    uint32_t flag;          // INTEGRITY_* bit this row reports
+    int32_t status;         // INTEGRITY_CHECK_*
+    int32_t matched_index;  // index of the matching path, -1 if none
+    int32_t detail;         // debugger: TracerPid; hook: INTEGRITY_MAPS_*
+    uint64_t duration_ns;   // cost of the run that produced this result
+    uint64_t age_ns;        // time since that run (0 = run by this call)
+} integrity_check_report;
+
+typedef struct {
+    uint32_t version;       // INTEGRITY_REPORT_VERSION
+    uint32_t flags;         // same bitmask as quick_probe_native()
+    uint32_t check_count;   // valid rows in checks[]
+    uint32_t reserved;
+    uint64_t probe_ns;      // wall time of this call
+    integrity_check_report checks[INTEGRITY_REPORT_MAX_CHECKS];
+} integrity_report;
+
+// Probes like quick_probe_native() (or full_probe_native() when [force])
+// and fills [report]. Returns the number of rows, or -1 on NULL.
+int integrity_report_fill(integrity_report *report, int force);
+
+// Resolves a row's matched_index to the path it found, or NULL.
+const char *integrity_check_path(uint32_t flag, int32_t index);
+
+// --- Batched path probe -----------------------------------------------------
+// Per-path result bits written by integrity_probe_paths().
+#define INTEGRITY_PATH_PRESENT    0x01 // lstat succeeded (file, dir or link)
+#define INTEGRITY_PATH_DIRECTORY  0x02
+#define INTEGRITY_PATH_EXECUTABLE 0x04 // accessible with X_OK for this uid
+#define INTEGRITY_PATH_DENIED     0x80 // a parent was not searchable: unknown
+
+// Checks [count] NUL-terminated paths in one call using fstatat/faccessat
+// (no symlink following) and writes one result byte per path into
+// [results]. Returns the number of present paths, or -1 on bad arguments.
+int integrity_probe_paths(const char *const *paths, size_t count,
+                          uint8_t *results);
+
+// --- Memory map scanner -----------------------------------------------------
+// Bits returned by integrity_scan_maps().
+#define INTEGRITY_MAPS_FRIDA      0x01 // frida-agent / gadget / gum-js
+#define INTEGRITY_MAPS_SUBSTRATE  0x02 // Cydia Substrate
+#define INTEGRITY_MAPS_XPOSED     0x04 // Xposed, EdXposed, LSPosed, Riru
+#define INTEGRITY_MAPS_HOOK_LIB   0x08 // inline-hook libraries (Dobby, ...)
+#define INTEGRITY_MAPS_MAGISK     0x10 // Magisk / Zygisk modules
+#define INTEGRITY_MAPS_ANON_RWX   0x20 // unnamed writable+executable region
+
+// Streams /proc/self/maps once and matches every mapped path against the
+// signature set with a precompiled Aho-Corasick automaton. Returns the
+// INTEGRITY_MAPS_* bits found, or -1 if maps cannot be read (non-Linux).
+// If [rwx_regions] is not NULL it receives the number of unnamed RWX
+// mappings; named ones ([anon:*], /memfd:*, such as ART's JIT cache) are
+// legitimate runtime code caches and are not counted.
+int integrity_scan_maps(uint32_t *rwx_regions);
+
+// --- Code-section self-checksum ---------------------------------------------
+#define INTEGRITY_TEXT_DIGEST_BYTES 32
+#define INTEGRITY_TEXT_PAGE_BYTES   4096
+
+// Hashes the executable PT_LOAD segments of the loaded module whose file
+// name is [module] (e.g. "libapp.so") with BLAKE2b and caches a per-page
+// baseline. Later calls return the cached digest unless [refresh] is set.
+// Writes INTEGRITY_TEXT_DIGEST_BYTES into [digest] and returns the number
+// of text bytes covered, or -1 if the module is not loaded, the cache is
+// full or the platform has no dl_iterate_phdr().
+int64_t integrity_text_baseline(const char *module, uint8_t *digest,
+                                size_t digest_len, int refresh);
+
+// Re-hashes [pages] randomly chosen text pages of [module] (0 = all) and
+// compares them with the baseline in constant time. Returns 0 when they
+// match, 1 on a mismatch and -1 if no baseline was taken. Only valid for
+// modules that stay loaded (the app and this library).
+int integrity_text_verify(const char *module, uint32_t pages);
+
+// --- Library self-check -----------------------------------------------------
+#define INTEGRITY_SELF_DIGEST_BYTES 32
+
+// BLAKE2b-256 over every read-only PT_LOAD segment (code, rodata, dynamic
+// symbol tables) of this library as mapped in memory. The loader never
+// writes those segments, so the digest is the same on every launch and
+// under any ASLR slide, and only changes when the .so itself does. Writes
+// the digest into [digest] and returns the number of bytes hashed, or -1
+// where dl_iterate_phdr() is unavailable.
+int64_t integrity_self_digest(uint8_t *digest, size_t digest_len);
+
+// Runs integrity_self_digest() on a detached thread and reports through
+// [cb] with the byte count (or -1), the digest and the time taken. Each
+// call gets its own digest buffer, so concurrent checks (one per isolate)
+// never share one; it stays valid until the receiver passes it to
+// integrity_self_check_free(), which suits asynchronous callbacks such as
+// NativeCallable.listener. Returns 0 when the thread started, -1 when no
+// thread could be created.
+typedef void (*integrity_self_cb)(int64_t covered, const uint8_t *digest,
+                                  uint64_t elapsed_ns);
+int integrity_self_check_async(integrity_self_cb cb);
+
+// Releases a digest delivered by integrity_self_check_async().
+void integrity_self_check_free(const uint8_t *digest);
+
+// --- Device DNA -------------------------------------------------------------
+// Absorbs [context] (caller binding: app id, nonce, ...) and then the stable
+// hardware identifiers of this device – /proc/cpuinfo identity lines,
+// /sys/devices/soc0/*, board properties / DMI, rounded memory size – into
+// one streaming BLAKE2b state and writes [out_len] (16..64) bytes to [out].
+// Sources that are missing are absorbed as absent, so the output is
+// deterministic per device. Returns [out_len], or -1 on bad arguments.
+int device_fingerprint(const uint8_t *context, size_t context_len,
+                       uint8_t *out, size_t out_len);
+
+// --- Background monitor -----------------------------------------------------
+// Called from the monitor thread whenever the integrity bitmask changes.
+// [changed] holds the bits that flipped since the previous report. The first
+// report is delivered right after start so listeners know the baseline.
+typedef void (*integrity_event_cb)(uint32_t flags, uint32_t changed);
+
+// Starts a native monitor thread that polls TracerPid every [poll_ms]
+// (clamped to >= 50), reacts to inotify events on the sentinel directories
+// (su/Magisk/Xposed/Frida locations) and to shared-library load/unload,
+// and invokes [cb] on bitmask changes. Returns 0 on success, -1 if already
+// running, unsupported on this platform or the thread could not start.
+int integrity_monitor_start(integrity_event_cb cb, uint32_t poll_ms);
+
+// Stops the monitor and joins its thread; [cb] is never called afterwards.
+void integrity_monitor_stop();
+
+// Returns 1 while the monitor thread is running.
+int integrity_monitor_running();
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,131 @@
+#include "native_rng.h"
+#include "native_secmem.h"
+#include "sodium.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+/* ---------------------------------------------------------------------------
+ *  FAST-KEY-ERASURE CSPRNG
+ *
+ *  stream[] is one ChaCha20 keystream of 32 + RNG_BUFFER_BYTES bytes (16
+ *  blocks). Its first 32 bytes replace the key immediately and are wiped;
+ *  the rest is output, consumed from the front and wiped as it goes. A
+ *  zero nonce is fine because no key is ever used twice.
+ *
+ *  Bulk fills draw a 32-byte subkey from the buffer and run the keystream
+ *  directly into the caller's memory, so the cost is ChaCha20 itself with
+ *  no intermediate copy.
+ * -------------------------------------------------------------------------*/
+
+#define _RNG_BULK_MAX (1u << 30) // bytes per subkey, far below the 256 GiB limit
+
+typedef struct {
+    unsigned char key[crypto_stream_chacha20_ietf_KEYBYTES];
+    unsigned char stream[crypto_stream_chacha20_ietf_KEYBYTES + RNG_BUFFER_BYTES];
+    size_t avail; // unread bytes at the end of stream
+    uint64_t since_seed;
+    unsigned fork_gen;
+} _rng_state;
+
+static const unsigned char _rngNonce[crypto_stream_chacha20_ietf_NONCEBYTES];
+
+static __thread _rng_state* _rngState;
+static pthread_key_t _rngKey;
+static pthread_once_t _rngOnce = PTHREAD_ONCE_INIT;
+static _Atomic unsigned _rngForkGen = 0;
+
+// The child starts with a copy of the parent's state; force a reseed so
+// the two processes do not produce the same stream.
+static void _rng_atfork_child(void) {
+    atomic_fetch_add_explicit(&_rngForkGen, 1, memory_order_relaxed);
+}
+
+static void _rng_thread_exit(void* arg) {
+    secmem_free(arg, sizeof(_rng_state));
+}
+
+static void _rng_init_once(void) {
+    pthread_key_create(&_rngKey, _rng_thread_exit);
+    pthread_atfork(NULL, NULL, _rng_atfork_child);
+}
+
+static void _rng_refill(_rng_state* s) {
+    crypto_stream_chacha20_ietf(s->stream, sizeof s->stream, _rngNonce,
+                                s->key);
+    memcpy(s->key, s->stream, sizeof s->key);
+    sodium_memzero(s->stream, sizeof s->key);
+    s->avail = RNG_BUFFER_BYTES;
+}
+
+static void _rng_seed(_rng_state* s) {
+    unsigned char seed[sizeof s->key];
+    randombytes_buf(seed, sizeof seed);
+    for (size_t i = 0; i < sizeof seed; ++i) s->key[i] ^= seed[i];
+    sodium_memzero(seed, sizeof seed);
+    s->since_seed = 0;
+    s->fork_gen = atomic_load_explicit(&_rngForkGen, memory_order_relaxed);
+    _rng_refill(s); // overwrites anything still buffered
+}
+
+static _rng_state* _rng_get(void) {
+    _rng_state* s = _rngState;
+    if (s == NULL) {
+        if (sodium_init() < 0) return NULL;
+        pthread_once(&_rngOnce, _rng_init_once);
+        s = secmem_alloc(sizeof *s); // zeroed
+        if (s == NULL) return NULL;
+        pthread_setspecific(_rngKey, s);
+        _rngState = s;
+        _rng_seed(s);
+    } else if (s->since_seed >= RNG_RESEED_BYTES ||
+               s->fork_gen != atomic_load_explicit(&_rngForkGen,
+                                                   memory_order_relaxed)) {
+        _rng_seed(s);
+    }
+    return s;
+}
+
+static void _rng_take(_rng_state* s, uint8_t* out, size_t len) {
+    while (len > 0) {
+        if (s->avail == 0) _rng_refill(s);
+        unsigned char* src = s->stream + sizeof s->stream - s->avail;
+        const size_t n = len < s->avail ? len : s->avail;
+        memcpy(out, src, n);
+        sodium_memzero(src, n);
+        s->avail -= n;
+        out += n;
+        len -= n;
+    }
+}
+
+int rng_fill(uint8_t* buf, size_t len) {
+    if (len == 0) return 0;
+    if (buf == NULL) return -1;
+    _rng_state* s = _rng_get();
+    if (s == NULL) return -1;
+    s->since_seed += len;
+
+    if (len < RNG_BULK_BYTES) {
+        _rng_take(s, buf, len);
+        return 0;
+    }
+
+    unsigned char sub[crypto_stream_chacha20_ietf_KEYBYTES];
+    while (len > 0) {
+        const size_t n = len < _RNG_BULK_MAX ? len : _RNG_BULK_MAX;
+        _rng_take(s, sub, sizeof sub);
+        crypto_stream_chacha20_ietf(buf, n, _rngNonce, sub);
+        buf += n;
+        len -= n;
+    }
+    sodium_memzero(sub, sizeof sub);
+    return 0;
+}
+
+int rng_reseed(void) {
+    _rng_state* s = _rng_get();
+    if (s == NULL) return -1;
+    _rng_seed(s);
+    return 0;
+}
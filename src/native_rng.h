@@ -0,0 +1,44 @@
+// native_rng.h
+#ifndef NATIVE_RNG_H
+#define NATIVE_RNG_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Buffered CSPRNG for nonces, salts, keys and bulk random fills.
+//
+// Each thread runs ChaCha20 in fast-key-erasure mode: one keystream call
+// yields a new 32-byte key for the next call plus RNG_BUFFER_BYTES of
+// output, and bytes are wiped from the buffer as they are handed out, so
+// neither past outputs nor the key that produced them survive in memory.
+// The key is mixed with fresh OS randomness (randombytes_buf) when the
+// thread first uses the generator, every RNG_RESEED_BYTES of output, and
+// in a child after fork().
+//
+// Small requests are copied from the buffer, which avoids the getrandom()
+// syscall libsodium makes per call. Requests of RNG_BULK_BYTES or more
+// are written straight from the keystream under a one-off subkey, at
+// ChaCha20 speed. The per-thread state lives in the secure pool
+// (native_secmem.h).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RNG_BUFFER_BYTES  992
+#define RNG_BULK_BYTES    4096
+#define RNG_RESEED_BYTES  (64u * 1024 * 1024)
+
+// Fills [buf] with [len] random bytes. Returns 0, or -1 on bad arguments
+// or if libsodium / the per-thread state cannot be initialised (the
+// buffer is then left unfilled).
+int rng_fill(uint8_t *buf, size_t len);
+
+// Mixes fresh OS randomness into the calling thread's generator now and
+// discards its buffered output. Returns 0, or -1 on failure.
+int rng_reseed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_RNG_H
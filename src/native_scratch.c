@@ -0,0 +1,143 @@
+#include "native_scratch.h"
+#include "native_secmem.h"
+#include "sodium.h"
+#include <pthread.h>
+#include <string.h>
+
+/* ---------------------------------------------------------------------------
+ *  PER-THREAD SCRATCH ARENA
+ *
+ *  Chunks form a list whose offsets (base) grow monotonically, so a mark
+ *  is one integer: the offset of the first free byte in [cur], the last
+ *  chunk holding live data. Allocations only move forward from there,
+ *  skipping a chunk's tail when the next request does not fit; chunks
+ *  after [cur] are always empty.
+ *
+ *  Released bytes are wiped back to zero and fresh chunks are zero, so
+ *  every block starts zeroed without a memset per allocation.
+ * -------------------------------------------------------------------------*/
+
+typedef struct _scratch_chunk {
+    struct _scratch_chunk* next;
+    uint64_t base;    // arena offset of the first data byte
+    size_t cap;
+    size_t used;
+    size_t alloc_len; // size passed to secmem_free()
+} _scratch_chunk;
+
+#define _SCRATCH_HDR \
+    ((sizeof(_scratch_chunk) + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1))
+#define _SCRATCH_DATA(c) ((uint8_t*)(c) + _SCRATCH_HDR)
+
+typedef struct {
+    _scratch_chunk* first;
+    _scratch_chunk* cur;
+} _scratch_arena;
+
+static __thread _scratch_arena _scratch;
+static pthread_key_t _scratchKey;
+static pthread_once_t _scratchKeyOnce = PTHREAD_ONCE_INIT;
+
+static void _scratch_free_chain(_scratch_chunk* c) {
+    while (c != NULL) {
+        _scratch_chunk* next = c->next;
+        if (c->used > 0) sodium_memzero(_SCRATCH_DATA(c), c->used);
+        secmem_free(c, _SCRATCH_HDR);
+        c = next;
+    }
+}
+
+// Thread exit: nothing may still point into the arena.
+static void _scratch_thread_exit(void* arg) {
+    _scratch_arena* a = arg;
+    _scratch_free_chain(a->first);
+    a->first = a->cur = NULL;
+}
+
+static void _scratch_make_key(void) {
+    pthread_key_create(&_scratchKey, _scratch_thread_exit);
+}
+
+static _scratch_chunk* _scratch_new_chunk(size_t need, uint64_t base) {
+    size_t alloc_len = need + _SCRATCH_HDR;
+    if (alloc_len < SECMEM_MAX_CLASS) alloc_len = SECMEM_MAX_CLASS;
+    _scratch_chunk* c = secmem_alloc(alloc_len); // zeroed
+    if (c == NULL) return NULL;
+    c->base = base;
+    c->cap = alloc_len - _SCRATCH_HDR;
+    c->alloc_len = alloc_len;
+    return c;
+}
+
+void* scratch_alloc(size_t len) {
+    if (len > SIZE_MAX - _SCRATCH_HDR - SCRATCH_ALIGN) return NULL;
+    size_t need = (len + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+    if (need == 0) need = SCRATCH_ALIGN;
+
+    _scratch_arena* a = &_scratch;
+    if (a->first == NULL) {
+        _scratch_chunk* c = _scratch_new_chunk(need, 0);
+        if (c == NULL) return NULL;
+        pthread_once(&_scratchKeyOnce, _scratch_make_key);
+        pthread_setspecific(_scratchKey, a);
+        a->first = a->cur = c;
+    }
+
+    _scratch_chunk* c = a->cur;
+    while (c->cap - c->used < need) {
+        if (c->next == NULL) {
+            _scratch_chunk* n = _scratch_new_chunk(need, c->base + c->cap);
+            if (n == NULL) return NULL;
+            c->next = n;
+        }
+        c = c->next; // empty: everything after cur is
+    }
+    a->cur = c;
+    void* p = _SCRATCH_DATA(c) + c->used;
+    c->used += need;
+    return p;
+}
+
+uint64_t scratch_mark(void) {
+    const _scratch_chunk* c = _scratch.cur;
+    return c != NULL ? c->base + c->used : 0;
+}
+
+void scratch_release(uint64_t mark) {
+    _scratch_arena* a = &_scratch;
+    if (a->first == NULL) return;
+
+    _scratch_chunk* cur = a->first;
+    for (_scratch_chunk* c = a->first; c != NULL; c = c->next) {
+        if (c->used == 0) continue;
+        const size_t keep = mark <= c->base ? 0
+            : mark - c->base < c->used ? (size_t)(mark - c->base)
+            : c->used;
+        if (keep < c->used) {
+            sodium_memzero(_SCRATCH_DATA(c) + keep, c->used - keep);
+            c->used = keep;
+        }
+        if (c->used > 0) cur = c;
+    }
+    a->cur = cur;
+
+    if (cur->used == 0 && cur->alloc_len > SCRATCH_RETAIN_BYTES) {
+        _scratch_free_chain(a->first); // one oversized chunk; start over
+        a->first = a->cur = NULL;
+        return;
+    }
+
+    // Everything after cur is empty; keep it only up to the budget.
+    size_t retained = 0;
+    for (_scratch_chunk* c = a->first; c != cur->next; c = c->next) {
+        retained += c->alloc_len;
+    }
+    for (_scratch_chunk* prev = cur; prev->next != NULL; prev = prev->next) {
+        retained += prev->next->alloc_len;
+        if (retained > SCRATCH_RETAIN_BYTES) {
+            _scratch_free_chain(prev->next);
+            prev->next = NULL;
+            break;
+        }
+    }
+}
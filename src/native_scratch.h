@@ -0,0 +1,53 @@
+// native_scratch.h
+#ifndef NATIVE_SCRATCH_H
+#define NATIVE_SCRATCH_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-thread scratch arena for the temporaries of a single FFI operation
+// (input copies, keys, output buffers). Allocation bumps a pointer;
+// scratch_release() rewinds to a mark taken earlier and wipes everything
+// handed out since, so a caller brackets one operation with
+//
+//   uint64_t mark = scratch_mark();
+//   ... scratch_alloc() as often as needed ...
+//   scratch_release(mark);
+//
+// and nested helpers can do the same without disturbing the outer
+// operation. Blocks must not outlive the release or cross threads; a Dart
+// isolate stays on one thread for the length of a synchronous call
+// sequence, which is what makes this safe to drive from Dart.
+//
+// Chunks are SECMEM_MAX_CLASS (64 KiB) unless a request needs more. A
+// chunk of that size comes from the secure pool (native_secmem.h), so an
+// operation whose temporaries fit in it stays in locked memory and makes
+// no heap calls once the arena is warm. A bigger chunk is beyond the
+// pool's largest class and goes through secmem's malloc() fallback: it is
+// wiped, but not locked. Chunks are kept for reuse up to
+// SCRATCH_RETAIN_BYTES in total and released beyond that once the arena
+// is empty again, so payloads over 1 MiB hit malloc()/free() every call.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCRATCH_ALIGN         16
+#define SCRATCH_RETAIN_BYTES  (1u << 20)
+
+// Returns [len] zeroed bytes aligned to SCRATCH_ALIGN from the calling
+// thread's arena, or NULL when memory is exhausted. [len] 0 yields a valid
+// (unique) pointer so zero-length inputs need no special case.
+void *scratch_alloc(size_t len);
+
+// Current position of the calling thread's arena.
+uint64_t scratch_mark(void);
+
+// Wipes everything allocated on this thread since [mark] and rewinds to
+// it. Release marks in reverse order of taking them.
+void scratch_release(uint64_t mark);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_SCRATCH_H
@@ -0,0 +1,219 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // MADV_DONTDUMP
+#endif
+#include "native_secmem.h"
+#include "sodium.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+/* ---------------------------------------------------------------------------
+ *  SECURE MEMORY POOL
+ *
+ *  The region is mapped once, PROT_NONE around a read/write interior, so a
+ *  linear overrun off either end faults instead of reading neighbouring
+ *  heap. Slabs are handed out front to back, and only the front is
+ *  mlock()ed when RLIMIT_MEMLOCK is below the region size (Android grants
+ *  64 KiB), so the slabs in use are the locked ones for as long as
+ *  possible.
+ *
+ *  Each size class keeps a free list threaded through its freed blocks
+ *  plus a bump cursor into its newest slab. Slabs are never returned to
+ *  the region: the classes a process uses settle quickly and the whole
+ *  pool is a couple of MiB.
+ * -------------------------------------------------------------------------*/
+
+#define _SECMEM_SLABS       (SECMEM_REGION_BYTES / SECMEM_SLAB_BYTES)
+#define _SECMEM_MIN_SHIFT   5  // log2(SECMEM_MIN_CLASS)
+#define _SECMEM_CLASSES     12 // 32 B .. 64 KiB
+
+typedef struct _secmem_block {
+    struct _secmem_block* next;
+} _secmem_block;
+
+typedef struct {
+    pthread_mutex_t lock;
+    _secmem_block* free;
+    uint8_t* bump; // next never-used block in the current slab
+    uint8_t* end;
+} _secmem_class;
+
+static _secmem_class _secmemClasses[_SECMEM_CLASSES];
+static uint8_t _secmemSlabClass[_SECMEM_SLABS];
+static uint8_t* _secmemBase; // NULL if the region could not be mapped
+static uint32_t _secmemFlags;
+static size_t _secmemLocked;
+static pthread_once_t _secmemOnce = PTHREAD_ONCE_INIT;
+
+static _Atomic size_t _secmemNextSlab = 0;
+static _Atomic uint64_t _secmemInUse = 0;
+static _Atomic uint64_t _secmemPeak = 0;
+static _Atomic uint64_t _secmemPoolAllocs = 0;
+static _Atomic uint64_t _secmemFallbackAllocs = 0;
+
+static void _secmem_map(void) {
+    for (int c = 0; c < _SECMEM_CLASSES; ++c) {
+        pthread_mutex_init(&_secmemClasses[c].lock, NULL);
+    }
+
+    long page = sysconf(_SC_PAGESIZE);
+    const size_t guard = page > 0 ? (size_t)page : 4096;
+    const size_t total = SECMEM_REGION_BYTES + 2 * guard;
+    uint8_t* map = mmap(NULL, total, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (map == MAP_FAILED) return;
+    uint8_t* base = map + guard;
+    if (mprotect(base, SECMEM_REGION_BYTES, PROT_READ | PROT_WRITE) != 0) {
+        munmap(map, total);
+        return;
+    }
+    uint32_t flags = SECMEM_FLAG_MAPPED | SECMEM_FLAG_GUARDED;
+
+#if defined(MADV_DONTDUMP)
+    if (madvise(base, SECMEM_REGION_BYTES, MADV_DONTDUMP) == 0) {
+        flags |= SECMEM_FLAG_NODUMP;
+    }
+#elif defined(MADV_NOCORE)
+    if (madvise(base, SECMEM_REGION_BYTES, MADV_NOCORE) == 0) {
+        flags |= SECMEM_FLAG_NODUMP;
+    }
+#endif
+
+    size_t lock = SECMEM_REGION_BYTES;
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_MEMLOCK, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY &&
+        rl.rlim_cur < lock) {
+        lock = (size_t)rl.rlim_cur / SECMEM_SLAB_BYTES * SECMEM_SLAB_BYTES;
+    }
+    if (lock > 0 && mlock(base, lock) == 0) {
+        _secmemLocked = lock;
+        if (lock == SECMEM_REGION_BYTES) flags |= SECMEM_FLAG_LOCKED;
+    }
+
+    _secmemFlags = flags;
+    _secmemBase = base;
+}
+
+int secmem_init(void) {
+    pthread_once(&_secmemOnce, _secmem_map);
+    return _secmemBase != NULL ? 0 : -1;
+}
+
+// Smallest class index whose block size is >= len (len <= SECMEM_MAX_CLASS).
+static unsigned _secmem_class_of(size_t len) {
+    if (len <= SECMEM_MIN_CLASS) return 0;
+    return (unsigned)(64 - __builtin_clzll((unsigned long long)len - 1)) -
+           _SECMEM_MIN_SHIFT;
+}
+
+static void* _secmem_fallback(size_t len) {
+    atomic_fetch_add_explicit(&_secmemFallbackAllocs, 1, memory_order_relaxed);
+    return calloc(1, len);
+}
+
+void* secmem_alloc(size_t len) {
+    if (len == 0) return NULL;
+    if (len > SECMEM_MAX_CLASS || secmem_init() != 0) {
+        return _secmem_fallback(len);
+    }
+
+    const unsigned c = _secmem_class_of(len);
+    const size_t size = (size_t)SECMEM_MIN_CLASS << c;
+    _secmem_class* cls = &_secmemClasses[c];
+    void* p = NULL;
+
+    pthread_mutex_lock(&cls->lock);
+    if (cls->free != NULL) {
+        _secmem_block* b = cls->free;
+        cls->free = b->next;
+        b->next = NULL; // the rest of the block was wiped on free
+        p = b;
+    } else {
+        if (cls->bump == cls->end) {
+            size_t slab =
+                atomic_load_explicit(&_secmemNextSlab, memory_order_relaxed);
+            while (slab < _SECMEM_SLABS &&
+                   !atomic_compare_exchange_weak_explicit(
+                       &_secmemNextSlab, &slab, slab + 1,
+                       memory_order_relaxed, memory_order_relaxed)) {
+            }
+            if (slab < _SECMEM_SLABS) {
+                _secmemSlabClass[slab] = (uint8_t)c;
+                cls->bump = _secmemBase + slab * SECMEM_SLAB_BYTES;
+                cls->end = cls->bump + SECMEM_SLAB_BYTES;
+            }
+        }
+        if (cls->bump != cls->end) {
+            p = cls->bump; // fresh mapping, still zero
+            cls->bump += size;
+        }
+    }
+    pthread_mutex_unlock(&cls->lock);
+
+    if (p == NULL) return _secmem_fallback(len);
+
+    atomic_fetch_add_explicit(&_secmemPoolAllocs, 1, memory_order_relaxed);
+    const uint64_t used =
+        atomic_fetch_add_explicit(&_secmemInUse, size, memory_order_relaxed) +
+        size;
+    uint64_t peak = atomic_load_explicit(&_secmemPeak, memory_order_relaxed);
+    while (used > peak &&
+           !atomic_compare_exchange_weak_explicit(&_secmemPeak, &peak, used,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+    return p;
+}
+
+void secmem_free(void* ptr, size_t len) {
+    if (ptr == NULL) return;
+    uint8_t* p = ptr;
+    if (secmem_init() != 0 || p < _secmemBase ||
+        p >= _secmemBase + SECMEM_REGION_BYTES) {
+        if (len > 0) sodium_memzero(ptr, len);
+        free(ptr);
+        return;
+    }
+
+    const size_t slab = (size_t)(p - _secmemBase) / SECMEM_SLAB_BYTES;
+    const unsigned c = _secmemSlabClass[slab];
+    const size_t size = (size_t)SECMEM_MIN_CLASS << c;
+    // The whole block, not just [len]: callers such as free_string() pass
+    // strlen() + 1, which can be shorter than what was written, and
+    // secmem_alloc() hands free-list blocks out without wiping them again.
+    (void)len;
+    sodium_memzero(p, size);
+
+    _secmem_class* cls = &_secmemClasses[c];
+    _secmem_block* b = ptr;
+    pthread_mutex_lock(&cls->lock);
+    b->next = cls->free;
+    cls->free = b;
+    pthread_mutex_unlock(&cls->lock);
+
+    atomic_fetch_sub_explicit(&_secmemInUse, size, memory_order_relaxed);
+}
+
+int secmem_report_fill(secmem_report* out) {
+    if (out == NULL) return -1;
+    secmem_init();
+    memset(out, 0, sizeof *out);
+    out->version = SECMEM_REPORT_VERSION;
+    out->flags = _secmemFlags;
+    out->region_bytes = _secmemBase != NULL ? SECMEM_REGION_BYTES : 0;
+    out->locked_bytes = _secmemLocked;
+    const size_t slabs =
+        atomic_load_explicit(&_secmemNextSlab, memory_order_relaxed);
+    out->slabs_used = slabs;
+    out->in_use_bytes =
+        atomic_load_explicit(&_secmemInUse, memory_order_relaxed);
+    out->peak_bytes = atomic_load_explicit(&_secmemPeak, memory_order_relaxed);
+    out->pool_allocs =
+        atomic_load_explicit(&_secmemPoolAllocs, memory_order_relaxed);
+    out->fallback_allocs =
+        atomic_load_explicit(&_secmemFallbackAllocs, memory_order_relaxed);
+    return 0;
+}
@@ -0,0 +1,74 @@
+// native_secmem.h
+#ifndef NATIVE_SECMEM_H
+#define NATIVE_SECMEM_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Pool allocator for short-lived sensitive buffers (plaintext, derived
+// keys, decoded secrets). One region is mapped on first use, fenced by
+// PROT_NONE guard pages, locked into RAM as far as RLIMIT_MEMLOCK allows
+// and excluded from core dumps. It is carved into 64 KiB slabs, each
+// serving one power-of-two size class from SECMEM_MIN_CLASS to
+// SECMEM_MAX_CLASS. Blocks are wiped on free and come back zeroed.
+//
+// Unlike sodium_malloc() nothing is mapped or mprotect()ed per call, so an
+// allocation costs about as much as malloc(). Requests above
+// SECMEM_MAX_CLASS, or made while the pool is exhausted, fall back to
+// malloc() and are still wiped on free, but are neither locked nor hidden
+// from dumps.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SECMEM_REGION_BYTES
+#define SECMEM_REGION_BYTES (2u * 1024 * 1024)
+#endif
+#define SECMEM_SLAB_BYTES   (64u * 1024)
+#define SECMEM_MIN_CLASS    32u
+#define SECMEM_MAX_CLASS    SECMEM_SLAB_BYTES
+
+// Maps and locks the region now instead of on the first allocation.
+// Returns 0, or -1 if the region could not be mapped (allocations then
+// use the malloc() fallback).
+int secmem_init(void);
+
+// Returns [len] zeroed bytes, or NULL when [len] is 0 or memory is
+// exhausted.
+void *secmem_alloc(size_t len);
+
+// Wipes and releases [ptr]. Pool blocks are wiped in full whatever [len]
+// says; for plain malloc() pointers, which are also accepted so every
+// string handed out through free_string() can take this path, only the
+// first [len] bytes are wiped, so pass the allocated size. NULL is ignored.
+void secmem_free(void *ptr, size_t len);
+
+// secmem_report.flags
+#define SECMEM_FLAG_MAPPED   0x01 // region mapped; otherwise all fallback
+#define SECMEM_FLAG_LOCKED   0x02 // the whole region is mlock()ed
+#define SECMEM_FLAG_NODUMP   0x04 // MADV_DONTDUMP (or platform equivalent)
+#define SECMEM_FLAG_GUARDED  0x08 // guard pages in place
+
+// Fixed layout shared with Dart (ffi.Struct); bump the version on change.
+#define SECMEM_REPORT_VERSION 1
+
+typedef struct {
+    uint32_t version;         // SECMEM_REPORT_VERSION
+    uint32_t flags;           // SECMEM_FLAG_*
+    uint64_t region_bytes;
+    uint64_t locked_bytes;    // < region_bytes when RLIMIT_MEMLOCK is lower
+    uint64_t slabs_used;      // slabs assigned to a size class so far
+    uint64_t in_use_bytes;    // pool blocks currently handed out
+    uint64_t peak_bytes;
+    uint64_t pool_allocs;
+    uint64_t fallback_allocs; // served by malloc()
+} secmem_report;
+
+// Fills [out] (initialising the pool if needed). Returns 0, or -1 on NULL.
+int secmem_report_fill(secmem_report *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_SECMEM_H
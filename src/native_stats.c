@@ -0,0 +1,149 @@
+#include "native_stats.h"
+#include "native_trace.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+static const char* const _statsNames[STATS_FN_COUNT] = {
+    [STATS_FN_HASH_PASSWORD] = "hash_password",
+    [STATS_FN_VERIFY_PASSWORD] = "verify_password",
+    [STATS_FN_ENCRYPT_BYTES] = "encrypt_bytes",
+    [STATS_FN_DECRYPT_BYTES] = "decrypt_bytes",
+    [STATS_FN_HKDF_SHA256] = "hkdf_sha256",
+    [STATS_FN_DERIVE_SESSION_KEY] = "derive_session_key_b64",
+    [STATS_FN_PBKDF2_SHA256] = "pbkdf2_sha256_b64",
+    [STATS_FN_RANDOM_BYTES] = "random_bytes",
+    [STATS_FN_HASH_BYTES] = "hash_bytes",
+    [STATS_FN_HASH_FILE] = "hash_file",
+    [STATS_FN_ENCRYPT_BUFFER_HASHED] = "encrypt_buffer_hashed",
+    [STATS_FN_DECRYPT_BUFFER_HASHED] = "decrypt_buffer_hashed",
+    [STATS_FN_ENCRYPT_FILE_HASHED] = "encrypt_file_hashed",
+    [STATS_FN_DECRYPT_FILE_HASHED] = "decrypt_file_hashed",
+    [STATS_FN_HOTP_GENERATE] = "hotp_generate",
+    [STATS_FN_TOTP_VERIFY] = "totp_verify",
+    [STATS_FN_QUICK_PROBE] = "quick_probe_native",
+    [STATS_FN_FULL_PROBE] = "full_probe_native",
+    [STATS_FN_INTEGRITY_REPORT] = "integrity_report_fill",
+    [STATS_FN_PROBE_PATHS] = "integrity_probe_paths",
+    [STATS_FN_SCAN_MAPS] = "integrity_scan_maps",
+    [STATS_FN_SELF_DIGEST] = "integrity_self_digest",
+    [STATS_FN_BASE64_ENCODE] = "base64_encode",
+    [STATS_FN_BASE64_DECODE] = "base64_decode",
+};
+
+uint64_t stats_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+const char* native_crypto_stats_name(uint32_t fn) {
+    return fn < STATS_FN_COUNT ? _statsNames[fn] : NULL;
+}
+
+#if NATIVE_CRYPTO_STATS
+
+typedef struct {
+    _Atomic uint64_t calls;
+    _Atomic uint64_t bytes;
+    _Atomic uint64_t total_ns;
+    _Atomic uint64_t max_ns;
+    _Atomic uint64_t latency_hist[STATS_HIST_BUCKETS];
+    _Atomic uint64_t size_hist[STATS_HIST_BUCKETS];
+} _stats_counters;
+
+static _stats_counters _stats[STATS_FN_COUNT];
+static _Atomic uint64_t _statsWindowStart; // 0 = first use starts it
+
+static unsigned _log2_bucket(uint64_t v) {
+    unsigned b = v == 0 ? 0 : 63u - (unsigned)__builtin_clzll(v);
+    return b < STATS_HIST_BUCKETS ? b : STATS_HIST_BUCKETS - 1;
+}
+
+void stats_scope_end(stats_scope* scope) {
+    if (scope->fn >= STATS_FN_COUNT) return;
+    const uint64_t elapsed = stats_now_ns() - scope->start_ns;
+    _stats_counters* c = &_stats[scope->fn];
+
+    uint64_t zero = 0;
+    atomic_compare_exchange_strong_explicit(&_statsWindowStart, &zero,
+                                            scope->start_ns,
+                                            memory_order_relaxed,
+                                            memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&c->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->bytes, scope->bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->total_ns, elapsed, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->latency_hist[_log2_bucket(elapsed)], 1,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->size_hist[_log2_bucket(scope->bytes)], 1,
+                              memory_order_relaxed);
+
+    uint64_t max = atomic_load_explicit(&c->max_ns, memory_order_relaxed);
+    while (elapsed > max &&
+           !atomic_compare_exchange_weak_explicit(&c->max_ns, &max, elapsed,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+
+    trace_record(scope->fn, scope->start_ns, elapsed, scope->bytes);
+}
+
+int native_crypto_stats(native_crypto_stats_snapshot* out) {
+    if (out == NULL) return -1;
+    memset(out, 0, sizeof *out);
+    out->version = STATS_SNAPSHOT_VERSION;
+    out->fn_count = STATS_FN_COUNT;
+    out->enabled = 1;
+    const uint64_t start =
+        atomic_load_explicit(&_statsWindowStart, memory_order_relaxed);
+    out->window_ns = start ? stats_now_ns() - start : 0;
+
+    for (size_t f = 0; f < STATS_FN_COUNT; ++f) {
+        _stats_counters* c = &_stats[f];
+        native_stats_fn* o = &out->fns[f];
+        o->calls = atomic_load_explicit(&c->calls, memory_order_relaxed);
+        o->bytes = atomic_load_explicit(&c->bytes, memory_order_relaxed);
+        o->total_ns = atomic_load_explicit(&c->total_ns, memory_order_relaxed);
+        o->max_ns = atomic_load_explicit(&c->max_ns, memory_order_relaxed);
+        for (size_t b = 0; b < STATS_HIST_BUCKETS; ++b) {
+            o->latency_hist[b] =
+                atomic_load_explicit(&c->latency_hist[b], memory_order_relaxed);
+            o->size_hist[b] =
+                atomic_load_explicit(&c->size_hist[b], memory_order_relaxed);
+        }
+    }
+    return 0;
+}
+
+void native_crypto_stats_reset(void) {
+    for (size_t f = 0; f < STATS_FN_COUNT; ++f) {
+        _stats_counters* c = &_stats[f];
+        atomic_store_explicit(&c->calls, 0, memory_order_relaxed);
+        atomic_store_explicit(&c->bytes, 0, memory_order_relaxed);
+        atomic_store_explicit(&c->total_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&c->max_ns, 0, memory_order_relaxed);
+        for (size_t b = 0; b < STATS_HIST_BUCKETS; ++b) {
+            atomic_store_explicit(&c->latency_hist[b], 0, memory_order_relaxed);
+            atomic_store_explicit(&c->size_hist[b], 0, memory_order_relaxed);
+        }
+    }
+    atomic_store_explicit(&_statsWindowStart, stats_now_ns(),
+                          memory_order_relaxed);
+}
+
+#else // !NATIVE_CRYPTO_STATS
+
+void stats_scope_end(stats_scope* scope) { (void)scope; }
+
+int native_crypto_stats(native_crypto_stats_snapshot* out) {
+    if (out == NULL) return -1;
+    memset(out, 0, sizeof *out);
+    out->version = STATS_SNAPSHOT_VERSION;
+    out->fn_count = STATS_FN_COUNT;
+    return 0;
+}
+
+void native_crypto_stats_reset(void) {}
+
+#endif // NATIVE_CRYPTO_STATS
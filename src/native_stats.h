@@ -0,0 +1,120 @@
+// native_stats.h
+#ifndef NATIVE_STATS_H
+#define NATIVE_STATS_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-function call counters with log2 latency and size histograms for the
+// library's hot entry points. Updates are relaxed atomic adds, so the cost
+// is two clock reads and a handful of uncontended increments per call.
+//
+// Built in unless the library is compiled with NATIVE_CRYPTO_STATS=0; the
+// exported functions then still exist and report enabled = 0.
+
+#ifndef NATIVE_CRYPTO_STATS
+#define NATIVE_CRYPTO_STATS 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Instrumented functions; index into native_crypto_stats_snapshot.fns.
+#define STATS_FN_HASH_PASSWORD          0
+#define STATS_FN_VERIFY_PASSWORD        1
+#define STATS_FN_ENCRYPT_BYTES          2  // incl. the _ad variant
+#define STATS_FN_DECRYPT_BYTES          3  // incl. the _ad variant
+#define STATS_FN_HKDF_SHA256            4
+#define STATS_FN_DERIVE_SESSION_KEY     5
+#define STATS_FN_PBKDF2_SHA256          6
+#define STATS_FN_RANDOM_BYTES           7  // random_bytes + random_bytes_b64
+#define STATS_FN_HASH_BYTES             8
+#define STATS_FN_HASH_FILE              9
+#define STATS_FN_ENCRYPT_BUFFER_HASHED 10
+#define STATS_FN_DECRYPT_BUFFER_HASHED 11
+#define STATS_FN_ENCRYPT_FILE_HASHED   12
+#define STATS_FN_DECRYPT_FILE_HASHED   13
+#define STATS_FN_HOTP_GENERATE         14  // incl. totp_generate
+#define STATS_FN_TOTP_VERIFY           15
+#define STATS_FN_QUICK_PROBE           16
+#define STATS_FN_FULL_PROBE            17
+#define STATS_FN_INTEGRITY_REPORT      18
+#define STATS_FN_PROBE_PATHS           19
+#define STATS_FN_SCAN_MAPS             20
+#define STATS_FN_SELF_DIGEST           21
+#define STATS_FN_BASE64_ENCODE         22
+#define STATS_FN_BASE64_DECODE         23
+#define STATS_FN_COUNT                 24
+
+// Bucket i counts values v with floor(log2(v)) == i (bucket 0 also holds
+// 0); the last bucket collects everything larger. Latencies are in ns, so
+// 40 buckets reach ~18 minutes; sizes are in bytes.
+#define STATS_HIST_BUCKETS 40
+
+// Fixed layout shared with Dart (ffi.Struct); bump the version on change.
+#define STATS_SNAPSHOT_VERSION 2
+
+typedef struct {
+    uint64_t calls;
+    uint64_t bytes;         // payload bytes processed (0 for fixed-size)
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t latency_hist[STATS_HIST_BUCKETS];
+    uint64_t size_hist[STATS_HIST_BUCKETS];
+} native_stats_fn;
+
+typedef struct {
+    uint32_t version;       // STATS_SNAPSHOT_VERSION
+    uint32_t fn_count;      // STATS_FN_COUNT
+    uint32_t enabled;       // 0 when built with NATIVE_CRYPTO_STATS=0
+    uint32_t reserved;
+    uint64_t window_ns;     // since the first recorded call or last reset
+    native_stats_fn fns[STATS_FN_COUNT];
+} native_crypto_stats_snapshot;
+
+// Copies the current counters into [out]. Counters keep running while the
+// copy is taken, so rows are individually consistent only to within the
+// calls in flight. Returns 0, or -1 on NULL.
+int native_crypto_stats(native_crypto_stats_snapshot *out);
+
+// Zeroes all counters and restarts the window.
+void native_crypto_stats_reset(void);
+
+// Function name for a STATS_FN_* index (e.g. "encrypt_bytes"), or NULL.
+const char *native_crypto_stats_name(uint32_t fn);
+
+// --- Instrumentation (library sources only) ----------------------------------
+//
+//   STATS_SCOPE(STATS_FN_ENCRYPT_BYTES, len);
+//
+// at the top of a function records one call (and, while native_trace is
+// on, one trace span) when the enclosing scope is left, whichever return is
+// taken. STATS_BYTES(n) sets the size once it is known (e.g. after decoding
+// the input); STATS_ADD_BYTES(n) accumulates it for streaming functions.
+
+typedef struct {
+    uint32_t fn;
+    uint64_t bytes;
+    uint64_t start_ns;
+} stats_scope;
+
+uint64_t stats_now_ns(void);
+void stats_scope_end(stats_scope *scope);
+
+#if NATIVE_CRYPTO_STATS
+#define STATS_SCOPE(fn, nbytes)                                           \
+    stats_scope _stats_scope __attribute__((cleanup(stats_scope_end))) = \
+        {(fn), (uint64_t)(nbytes), stats_now_ns()}
+#define STATS_BYTES(nbytes) (_stats_scope.bytes = (uint64_t)(nbytes))
+#define STATS_ADD_BYTES(nbytes) (_stats_scope.bytes += (uint64_t)(nbytes))
+#else
+#define STATS_SCOPE(fn, nbytes) ((void)0)
+#define STATS_BYTES(nbytes) ((void)0)
+#define STATS_ADD_BYTES(nbytes) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_STATS_H
@@ -0,0 +1,178 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // syscall(SYS_gettid)
+#endif
+#include "native_trace.h"
+#include "native_stats.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/syscall.h>
+#endif
+
+// Each slot is a small seqlock: the writer clears [seq], fills the event and
+// publishes seq = index + 1; the reader keeps a slot only if [seq] matches
+// the index it expects before and after copying it.
+typedef struct {
+    _Atomic uint64_t seq;
+    uint64_t ts_ns;
+    uint64_t dur_ns;
+    uint64_t bytes;
+    uint32_t fn;
+    uint32_t tid;
+} _trace_event;
+
+static _trace_event* _traceRing;   // set once under _traceLock, never freed
+static uint64_t _traceMask;
+static _Atomic int _traceOn = 0;
+static _Atomic uint64_t _traceHead = 0;  // next index to write
+static _Atomic uint64_t _traceFloor = 0; // first index the dump reports
+static pthread_mutex_t _traceLock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t _trace_tid(void) {
+    static __thread uint32_t tid;
+    if (tid == 0) {
+#if defined(__linux__) || defined(__ANDROID__)
+        tid = (uint32_t)syscall(SYS_gettid);
+#elif defined(__APPLE__)
+        uint64_t id = 0;
+        pthread_threadid_np(NULL, &id);
+        tid = (uint32_t)id;
+#else
+        tid = (uint32_t)(uintptr_t)pthread_self();
+#endif
+    }
+    return tid;
+}
+
+int64_t native_trace_start(uint32_t capacity) {
+    pthread_mutex_lock(&_traceLock);
+    if (_traceRing == NULL) {
+        if (capacity == 0) capacity = TRACE_DEFAULT_EVENTS;
+        if (capacity > TRACE_MAX_EVENTS) capacity = TRACE_MAX_EVENTS;
+        uint64_t n = TRACE_MIN_EVENTS;
+        while (n < capacity) n <<= 1;
+        _trace_event* ring = calloc(n, sizeof *ring);
+        if (ring == NULL) {
+            pthread_mutex_unlock(&_traceLock);
+            return -1;
+        }
+        _traceMask = n - 1;
+        _traceRing = ring;
+    }
+    const int64_t cap = (int64_t)_traceMask + 1;
+    atomic_store_explicit(&_traceOn, 1, memory_order_release);
+    pthread_mutex_unlock(&_traceLock);
+    return cap;
+}
+
+void native_trace_stop(void) {
+    atomic_store_explicit(&_traceOn, 0, memory_order_release);
+}
+
+int native_trace_enabled(void) {
+    return atomic_load_explicit(&_traceOn, memory_order_relaxed);
+}
+
+void trace_record(uint32_t fn, uint64_t start_ns, uint64_t dur_ns,
+                  uint64_t bytes) {
+    // _traceOn is only set after the ring is published.
+    if (!atomic_load_explicit(&_traceOn, memory_order_acquire)) return;
+    const uint64_t idx =
+        atomic_fetch_add_explicit(&_traceHead, 1, memory_order_relaxed);
+    _trace_event* e = &_traceRing[idx & _traceMask];
+    atomic_store_explicit(&e->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    e->ts_ns = start_ns;
+    e->dur_ns = dur_ns;
+    e->bytes = bytes;
+    e->fn = fn;
+    e->tid = _trace_tid();
+    atomic_store_explicit(&e->seq, idx + 1, memory_order_release);
+}
+
+// Appends with snprintf semantics; [*len] tracks the would-be length so a
+// short buffer is detected after the fact.
+__attribute__((format(printf, 4, 5)))
+static void _append(char* buf, size_t cap, size_t* len, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(*len < cap ? buf + *len : NULL,
+                      *len < cap ? cap - *len : 0, fmt, ap);
+    va_end(ap);
+    if (n > 0) *len += (size_t)n;
+}
+
+// Upper bound of one rendered event; names are at most ~32 characters.
+#define _TRACE_EVENT_JSON_BYTES 224
+
+char* native_trace_dump_json(int clear) {
+    pthread_mutex_lock(&_traceLock);
+    const uint64_t head =
+        atomic_load_explicit(&_traceHead, memory_order_acquire);
+    uint64_t first = atomic_load_explicit(&_traceFloor, memory_order_relaxed);
+    uint64_t dropped = 0;
+    if (_traceRing != NULL && head - first > _traceMask + 1) {
+        dropped = head - first - (_traceMask + 1);
+        first = head - (_traceMask + 1);
+    }
+    if (_traceRing == NULL) first = head;
+
+    const size_t cap = 256 + (size_t)(head - first) * _TRACE_EVENT_JSON_BYTES;
+    char* out = malloc(cap);
+    if (out == NULL) {
+        pthread_mutex_unlock(&_traceLock);
+        return NULL;
+    }
+
+    const int pid = (int)getpid();
+    size_t len = 0;
+    _append(out, cap, &len, "{\"traceEvents\":[");
+    int count = 0;
+    for (uint64_t idx = first; idx < head; ++idx) {
+        _trace_event* e = &_traceRing[idx & _traceMask];
+        if (atomic_load_explicit(&e->seq, memory_order_acquire) != idx + 1) {
+            continue; // not yet published, or already overwritten
+        }
+        _trace_event copy;
+        copy.ts_ns = e->ts_ns;
+        copy.dur_ns = e->dur_ns;
+        copy.bytes = e->bytes;
+        copy.fn = e->fn;
+        copy.tid = e->tid;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&e->seq, memory_order_relaxed) != idx + 1) {
+            continue;
+        }
+        const char* name = native_crypto_stats_name(copy.fn);
+        _append(out, cap, &len,
+                "%s\n{\"name\":\"%s\",\"cat\":\"native_crypto\",\"ph\":\"X\","
+                "\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"pid\":%d,\"tid\":%u,"
+                "\"args\":{\"bytes\":%llu}}",
+                count++ ? "," : "", name != NULL ? name : "unknown",
+                (unsigned long long)(copy.ts_ns / 1000),
+                (unsigned)(copy.ts_ns % 1000),
+                (unsigned long long)(copy.dur_ns / 1000),
+                (unsigned)(copy.dur_ns % 1000), pid, copy.tid,
+                (unsigned long long)copy.bytes);
+    }
+    _append(out, cap, &len,
+            "\n],\"displayTimeUnit\":\"ns\","
+            "\"otherData\":{\"clock\":\"CLOCK_MONOTONIC\",\"dropped\":%llu}}\n",
+            (unsigned long long)dropped);
+
+    if (clear) {
+        atomic_store_explicit(&_traceFloor, head, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&_traceLock);
+
+    if (len >= cap) { // cannot happen with the per-event bound above
+        free(out);
+        return NULL;
+    }
+    return out;
+}
@@ -0,0 +1,56 @@
+// native_trace.h
+#ifndef NATIVE_TRACE_H
+#define NATIVE_TRACE_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Optional span tracing for the library's instrumented entry points (the
+// STATS_SCOPE sites in native_stats.h). While tracing is on, every call
+// leaves one complete ("ph":"X") event with its start, duration, thread and
+// payload size in a fixed-size in-memory ring; old events are overwritten.
+// The ring is dumped as Chrome trace JSON, which Perfetto and
+// chrome://tracing load directly.
+//
+// Timestamps are CLOCK_MONOTONIC microseconds, the clock Dart's timeline
+// uses on Linux and Android, so the events can be merged into a Flutter
+// timeline export and line up with the Dart spans.
+//
+// When tracing is off the cost per call is one atomic load. A library built
+// with NATIVE_CRYPTO_STATS=0 has no scopes and records nothing.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACE_MIN_EVENTS      256
+#define TRACE_MAX_EVENTS      (1u << 20)
+#define TRACE_DEFAULT_EVENTS  16384
+
+// Turns tracing on. The ring is allocated on the first call with
+// [capacity] events (0 = TRACE_DEFAULT_EVENTS, rounded up to a power of two
+// within the limits above) and kept for the life of the process; later
+// calls reuse it. Returns the ring capacity, or -1 if it cannot be
+// allocated.
+int64_t native_trace_start(uint32_t capacity);
+
+// Turns tracing off. Recorded events stay available to the dump.
+void native_trace_stop(void);
+
+// Returns non-zero while tracing is on.
+int native_trace_enabled(void);
+
+// Renders the events in the ring, oldest first, as a Chrome trace JSON
+// object ({"traceEvents": [...], ...}). With [clear] the dumped events are
+// dropped so the next dump starts after them. Returns a malloc'd string the
+// caller frees with free_string(), or NULL on allocation failure.
+char *native_trace_dump_json(int clear);
+
+// Records one span; called by the instrumentation scopes.
+void trace_record(uint32_t fn, uint64_t start_ns, uint64_t dur_ns,
+                  uint64_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_TRACE_H
@@ -0,0 +1,52 @@
+// native_wipe.h
+#ifndef NATIVE_WIPE_H
+#define NATIVE_WIPE_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Multi-pass secure file wipe: each file is overwritten in place with large
+// page-aligned writes, synced to storage after every pass, then truncated
+// and unlinked. Files are spread over a small pool of worker threads.
+//
+// On flash storage with wear levelling an overwrite is not guaranteed to
+// reach the original cells; the vault is encrypted, so this is a second
+// line of defence that destroys the ciphertext on every layer the OS
+// exposes.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pass content. Without WIPE_FLAG_PATTERNS every pass is ChaCha20
+// keystream; with it passes alternate 0x00 / 0xFF and the last one is
+// random (DoD 5220.22-M style).
+#define WIPE_FLAG_PATTERNS 0x01
+// Bypass the page cache (O_DIRECT on Linux/Android, F_NOCACHE on Apple).
+// Falls back to buffered I/O when the filesystem refuses it.
+#define WIPE_FLAG_DIRECT   0x02
+
+#define WIPE_MAX_PASSES    35
+#define WIPE_MAX_THREADS   16
+
+// Per-file outcome written to results[i].
+#define WIPE_RESULT_DONE     0 // every pass written, truncated and unlinked
+#define WIPE_RESULT_PARTIAL  1 // deadline hit after the first pass; unlinked
+#define WIPE_RESULT_MISSING  2 // path did not exist
+#define WIPE_RESULT_FAILED  -1 // open/write/unlink failed (unlink still tried)
+
+// Wipes [count] regular files with [passes] (1..WIPE_MAX_PASSES) overwrite
+// passes using up to [threads] workers (0 = one per CPU, capped at 4).
+// When [deadline_ms] is non-zero and elapses, files finish the pass in
+// progress (at least one full pass is always written) and skip straight to
+// truncate + unlink. Symlinks are unlinked without following them.
+// [results] (optional) receives one WIPE_RESULT_* per path. Returns the
+// number of files with WIPE_RESULT_DONE, or -1 on bad arguments.
+int secure_wipe_files(const char* const* paths, size_t count, uint32_t passes,
+                      uint32_t flags, uint32_t threads, uint32_t deadline_ms,
+                      int8_t* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_WIPE_H
@@ -0,0 +1,100 @@
+// otp_vectors.c
+//
+// Known-answer test for the native HOTP/TOTP code: the RFC 4226 Appendix D
+// HOTP values, the RFC 6238 Appendix B TOTP table for SHA-1, SHA-256 and
+// SHA-512, a Base32 secret and the totp_verify() drift window. Reports
+// every mismatch and exits non-zero if there was any; ctest runs this as
+// native_otp_vectors.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "native_crypto.h"
+
+static int _failures = 0;
+
+static void _expect(const char* what, int64_t got, int64_t want) {
+    if (got != want) {
+        fprintf(stderr, "FAIL %s: got %lld, want %lld\n", what,
+                (long long)got, (long long)want);
+        ++_failures;
+    }
+}
+
+// RFC 6238 uses a key of the hash output length for each algorithm.
+static const char _seed20[] = "12345678901234567890";
+static const char _seed32[] = "12345678901234567890123456789012";
+static const char _seed64[] =
+    "1234567890123456789012345678901234567890123456789012345678901234";
+
+static const int64_t _hotp[10] = {
+    755224, 287082, 359152, 969429, 338314,
+    254676, 287922, 162583, 399871, 520489,
+};
+
+static const struct {
+    uint64_t time;
+    int64_t sha1, sha256, sha512;
+} _totp[] = {
+    {59ull,          94287082, 46119246, 90693936},
+    {1111111109ull,  7081804,  68084774, 25091201},
+    {1111111111ull,  14050471, 67062674, 99943326},
+    {1234567890ull,  89005924, 91819424, 93441116},
+    {2000000000ull,  69279037, 90698825, 38618901},
+    {20000000000ull, 65353130, 77737706, 47863826},
+};
+
+int main(void) {
+    otp_key* k1 = otp_key_new(OTP_ALG_SHA1, (const uint8_t*)_seed20, 20);
+    otp_key* k256 = otp_key_new(OTP_ALG_SHA256, (const uint8_t*)_seed32, 32);
+    otp_key* k512 = otp_key_new(OTP_ALG_SHA512, (const uint8_t*)_seed64, 64);
+    // Base32 of _seed20.
+    otp_key* kb32 = otp_key_new_base32(OTP_ALG_SHA1,
+                                       "GEZDGNBV GY3TQOJQ gezdgnbv gy3tqojq");
+    if (!k1 || !k256 || !k512 || !kb32) {
+        fprintf(stderr, "FAIL otp_key_new\n");
+        return 1;
+    }
+
+    char what[64];
+    for (int i = 0; i < 10; ++i) {
+        snprintf(what, sizeof what, "hotp counter %d", i);
+        _expect(what, hotp_generate(k1, (uint64_t)i, 6), _hotp[i]);
+    }
+    for (size_t i = 0; i < sizeof _totp / sizeof _totp[0]; ++i) {
+        const uint64_t t = _totp[i].time;
+        snprintf(what, sizeof what, "totp sha1 t=%llu", (unsigned long long)t);
+        _expect(what, totp_generate(k1, t, 30, 8), _totp[i].sha1);
+        snprintf(what, sizeof what, "totp sha256 t=%llu", (unsigned long long)t);
+        _expect(what, totp_generate(k256, t, 30, 8), _totp[i].sha256);
+        snprintf(what, sizeof what, "totp sha512 t=%llu", (unsigned long long)t);
+        _expect(what, totp_generate(k512, t, 30, 8), _totp[i].sha512);
+    }
+    _expect("totp base32", totp_generate(kb32, 59, 30, 8), 94287082);
+
+    // The t=59 code is accepted one step either side with window 1, with
+    // the matching offset reported, and rejected two steps away.
+    int32_t off = 99;
+    _expect("verify same step", totp_verify(k1, 59, 30, 8, 94287082, 1, &off), 1);
+    _expect("verify same step offset", off, 0);
+    _expect("verify next step", totp_verify(k1, 89, 30, 8, 94287082, 1, &off), 1);
+    _expect("verify next step offset", off, -1);
+    _expect("verify prev step", totp_verify(k1, 29, 30, 8, 94287082, 1, &off), 1);
+    _expect("verify prev step offset", off, 1);
+    _expect("verify out of window",
+            totp_verify(k1, 149, 30, 8, 94287082, 1, NULL), 0);
+    _expect("verify window 0", totp_verify(k1, 89, 30, 8, 94287082, 0, NULL), 0);
+    _expect("verify bad digits", totp_verify(k1, 59, 30, 4, 1234, 1, NULL), -1);
+
+    otp_key_free(k1);
+    otp_key_free(k256);
+    otp_key_free(k512);
+    otp_key_free(kb32);
+
+    if (_failures != 0) {
+        fprintf(stderr, "%d OTP vector(s) failed\n", _failures);
+        return 1;
+    }
+    printf("all OTP vectors passed\n");
+    return 0;
+}